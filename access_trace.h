@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// access_trace.h
+//
+// Identification: src/include/buffer/access_trace.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdlib>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "buffer/replacer.h"
+
+namespace bustub
+{
+
+  /** One access of a page access trace. */
+  struct TraceRecord
+  {
+    page_id_t page_id_;
+    AccessType access_type_;
+  };
+
+  /**
+   * Streams the records of a page access trace, the text format trace_replay and shards_simulator
+   * read. Each line is one access, "<page_id> [L|S|I]", where the optional letter is the AccessType
+   * (Lookup, Scan, Index; Unknown when omitted). Blank lines and lines whose first non-blank
+   * character is '#' are skipped. A malformed line throws std::runtime_error naming its line number.
+   */
+  class TraceReader
+  {
+  public:
+    explicit TraceReader(std::istream &in) : in_(in) {}
+
+    /** @return false once the trace is exhausted. */
+    auto Next(TraceRecord *record) -> bool
+    {
+      while (std::getline(in_, line_))
+      {
+        line_no_++;
+        if (ParseLine(line_.c_str(), record))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+  private:
+    static auto IsBlank(char c) -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+    /*ParseLine解析一行：空行和注释返回 false，访问类型只看该字段的第一个字母*/
+    auto ParseLine(const char *line, TraceRecord *record) const -> bool
+    {
+      while (IsBlank(*line))
+      {
+        line++;
+      }
+      if (*line == '\0' || *line == '#')
+      {
+        return false;
+      }
+      char *end;
+      long long value = std::strtoll(line, &end, 10); // NOLINT
+      if (end == line || value < 0 || value > std::numeric_limits<page_id_t>::max())
+      {
+        throw Error("bad page id");
+      }
+      record->page_id_ = static_cast<page_id_t>(value);
+      while (IsBlank(*end))
+      {
+        end++;
+      }
+      switch (*end)
+      {
+      case 'L':
+        record->access_type_ = AccessType::Lookup;
+        break;
+      case 'S':
+        record->access_type_ = AccessType::Scan;
+        break;
+      case 'I':
+        record->access_type_ = AccessType::Index;
+        break;
+      case '\0':
+        record->access_type_ = AccessType::Unknown;
+        break;
+      default:
+        throw Error("bad access type");
+      }
+      return true;
+    }
+
+    auto Error(const char *what) const -> std::runtime_error
+    {
+      return std::runtime_error(std::string(what) + " at line " + std::to_string(line_no_));
+    }
+
+    std::istream &in_;
+    std::string line_;
+    size_t line_no_{0};
+  };
+
+  /** The name a policy goes by on the command line of the trace tools. */
+  struct PolicyName
+  {
+    const char *name_;
+    ReplacerPolicy policy_;
+  };
+
+  inline constexpr PolicyName POLICIES[] = {{"lru_k", ReplacerPolicy::LRUK},
+                                            {"partitioned_lru_k", ReplacerPolicy::PartitionedLRUK},
+                                            {"arc", ReplacerPolicy::ARC},
+                                            {"2q", ReplacerPolicy::TwoQueue},
+                                            {"clock", ReplacerPolicy::Clock}};
+
+} // namespace bustub
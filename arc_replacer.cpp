@@ -0,0 +1,127 @@
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub
+{
+
+  ArcReplacer::ArcReplacer(size_t num_frames) : capacity_(num_frames), frames_(num_frames), lists_(num_frames, 2) {}
+
+  /*Evict淘汰帧：T1 超过目标大小p时淘汰 T1 中最久未访问的可驱逐帧，否则淘汰 T2 中的
+   选中的链表没有可驱逐帧时改用另一个链表。
+   被淘汰帧的页面记入对应的幽灵链表，T1 与 B1 合计、以及四个链表合计分别不超过 c 与 2c。
+   只被扫描访问过的帧不记入幽灵链表，扫描读入的页面再次读入时不会调整p。
+  */
+  auto ArcReplacer::Evict(frame_id_t *frame_id) -> bool
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (lists_.NumEvictable() == 0)
+    {
+      return false;
+    }
+    int list = lists_.Size(T1) > target_t1_ ? T1 : T2;
+    frame_id_t victim = lists_.FindVictim(list);
+    if (victim == FrameLists::NONE)
+    {
+      list = 1 - list;
+      victim = lists_.FindVictim(list);
+    }
+
+    lists_.Erase(victim);
+    FrameInfo &frame = frames_[victim];
+    if (frame.page_id != INVALID_PAGE_ID && !frame.scan_only)
+    {
+      if (list == T1)
+      {
+        b1_.Push(frame.page_id);
+        while (lists_.Size(T1) + b1_.Size() > capacity_)
+        {
+          b1_.PopOldest();
+        }
+      }
+      else
+      {
+        b2_.Push(frame.page_id);
+        while (lists_.Size(T1) + lists_.Size(T2) + b1_.Size() + b2_.Size() > 2 * capacity_)
+        {
+          b2_.PopOldest();
+        }
+      }
+    }
+    frame = FrameInfo{};
+    *frame_id = victim;
+    return true;
+  }
+
+  /*RecordAccess记录帧访问
+   已在 T1 或 T2 中的帧移到 T2 的最前端。
+   新帧的页面在 B1 中时说明 T1 太小，增大p；在 B2 中时说明 T2 太小，减小p；这两种情况帧直接进入 T2，
+   否则进入 T1。
+  */
+  void ArcReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < capacity_, "Invalid frame_id!");
+    FrameInfo &frame = frames_[frame_id];
+    if (lists_.ListOf(frame_id) != -1)
+    {
+      if (access_type != AccessType::Scan)
+      {
+        frame.scan_only = false;
+        lists_.MoveToFront(T2, frame_id);
+      }
+      return;
+    }
+
+    frame.page_id = page_id;
+    frame.scan_only = access_type == AccessType::Scan;
+    if (access_type == AccessType::Scan || page_id == INVALID_PAGE_ID)
+    {
+      lists_.PushFront(T1, frame_id);
+    }
+    else if (b1_.Erase(page_id))
+    {
+      size_t delta = std::max<size_t>(1, b2_.Size() / (b1_.Size() + 1));
+      target_t1_ = std::min(capacity_, target_t1_ + delta);
+      lists_.PushFront(T2, frame_id);
+    }
+    else if (b2_.Erase(page_id))
+    {
+      size_t delta = std::max<size_t>(1, b1_.Size() / (b2_.Size() + 1));
+      target_t1_ = target_t1_ > delta ? target_t1_ - delta : 0;
+      lists_.PushFront(T2, frame_id);
+    }
+    else
+    {
+      lists_.PushFront(T1, frame_id);
+    }
+  }
+
+  void ArcReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < capacity_, "Invalid frame_id!");
+    lists_.SetEvictable(frame_id, set_evictable);
+  }
+
+  // Remove移除指定帧：页面已被删除，不记入幽灵链表
+  void ArcReplacer::Remove(frame_id_t frame_id)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= capacity_)
+    {
+      return;
+    }
+    if (lists_.Remove(frame_id))
+    {
+      frames_[frame_id] = FrameInfo{};
+    }
+  }
+
+  auto ArcReplacer::Size() -> size_t
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return lists_.NumEvictable();
+  }
+
+} // namespace bustub
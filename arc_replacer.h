@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mutex> // NOLINT
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  /**
+   * ArcReplacer implements Adaptive Replacement Cache (Megiddo and Modha, FAST '03).
+   *
+   * Resident frames are in T1 (seen once recently) or T2 (seen at least twice), both in LRU order.
+   * The pages of frames evicted from them are remembered in the ghost lists B1 and B2. A page read
+   * back while its ghost is in B1 grows the target size p of T1, one in B2 shrinks it, and Evict
+   * takes the LRU evictable frame of T1 while T1 is larger than p, of T2 otherwise.
+   *
+   * Ghost hits need the page id passed to RecordAccess. Scan accesses never promote a frame to T2
+   * and never consult the ghosts, and a frame that was only ever scanned leaves no ghost behind.
+   */
+  class ArcReplacer : public Replacer
+  {
+  public:
+    explicit ArcReplacer(size_t num_frames);
+
+    DISALLOW_COPY_AND_MOVE(ArcReplacer);
+
+    ~ArcReplacer() override = default;
+
+    auto Evict(frame_id_t *frame_id) -> bool override;
+
+    void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                      page_id_t page_id = INVALID_PAGE_ID) override;
+
+    void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+    void Remove(frame_id_t frame_id) override;
+
+    auto Size() -> size_t override;
+
+  private:
+    static constexpr int T1 = 0;
+    static constexpr int T2 = 1;
+
+    struct FrameInfo
+    {
+      page_id_t page_id{INVALID_PAGE_ID};
+      bool scan_only{false}; // 只被扫描访问过，淘汰时不记入幽灵链表
+    };
+
+    size_t capacity_;
+    size_t target_t1_{0}; // 自适应参数p：T1 的目标大小
+    std::mutex latch_;
+
+    std::vector<FrameInfo> frames_;
+    FrameLists lists_;
+    GhostList b1_;
+    GhostList b2_;
+  };
+
+} // namespace bustub
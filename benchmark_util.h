@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// benchmark_util.h
+//
+// Identification: tools/benchmark/benchmark_util.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+namespace bustub {
+
+/**
+ * A xorshift64 generator. Each benchmark thread owns one, so threads do not contend on a shared
+ * std::mt19937; seeds are spread out so that small consecutive seeds give unrelated sequences.
+ */
+class XorShift {
+ public:
+  explicit XorShift(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ULL + 1) {}
+
+  auto Next() -> uint64_t {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 7;
+    state_ ^= state_ << 17;
+    return state_;
+  }
+
+ private:
+  uint64_t state_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,109 @@
+#include "buffer/clock_replacer.h"
+
+#include <stdexcept>
+
+namespace bustub
+{
+
+  ClockReplacer::ClockReplacer(size_t num_frames) : replacer_size_(num_frames), frames_(num_frames) {}
+
+  /*Evict淘汰帧：时钟指针依次经过每个帧
+   跳过未跟踪和不可驱逐的帧；引用位已置位的帧清除引用位后跳过（第二次机会），
+   遇到的第一个引用位为0的可驱逐帧被淘汰。
+   转过两圈后不再给第二次机会，保证并发置位的访问不会让淘汰无限进行下去。
+  */
+  auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (curr_size_ == 0)
+    {
+      return false;
+    }
+    for (size_t step = 0;; step++)
+    {
+      size_t victim = hand_;
+      hand_ = (hand_ + 1) % replacer_size_;
+      FrameInfo &frame = frames_[victim];
+      if (!frame.tracked.load(std::memory_order_relaxed) || !frame.is_evictable)
+      {
+        continue;
+      }
+      if (step < 2 * replacer_size_ && frame.referenced.exchange(false, std::memory_order_relaxed))
+      {
+        continue;
+      }
+      frame.tracked.store(false, std::memory_order_relaxed);
+      frame.referenced.store(false, std::memory_order_relaxed);
+      frame.is_evictable = false;
+      curr_size_--;
+      *frame_id = static_cast<frame_id_t>(victim);
+      return true;
+    }
+  }
+
+  /*RecordAccess记录帧访问
+   已跟踪的帧只需置位引用位，不加锁；新帧加锁后开始跟踪，引用位为0。
+  */
+  void ClockReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type,
+                                   [[maybe_unused]] page_id_t page_id)
+  {
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    FrameInfo &frame = frames_[frame_id];
+    if (frame.tracked.load(std::memory_order_acquire))
+    {
+      if (access_type != AccessType::Scan)
+      {
+        frame.referenced.store(true, std::memory_order_relaxed);
+      }
+      return;
+    }
+    std::scoped_lock<std::mutex> lock(latch_);
+    frame.tracked.store(true, std::memory_order_release);
+  }
+
+  void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    FrameInfo &frame = frames_[frame_id];
+    if (!frame.tracked.load(std::memory_order_relaxed) || frame.is_evictable == set_evictable)
+    {
+      return;
+    }
+    frame.is_evictable = set_evictable;
+    if (set_evictable)
+    {
+      curr_size_++;
+    }
+    else
+    {
+      curr_size_--;
+    }
+  }
+
+  void ClockReplacer::Remove(frame_id_t frame_id)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_ ||
+        !frames_[frame_id].tracked.load(std::memory_order_relaxed))
+    {
+      return;
+    }
+    FrameInfo &frame = frames_[frame_id];
+    if (!frame.is_evictable)
+    {
+      throw std::runtime_error("Cannot remove a non-evictable frame");
+    }
+    frame.tracked.store(false, std::memory_order_relaxed);
+    frame.referenced.store(false, std::memory_order_relaxed);
+    frame.is_evictable = false;
+    curr_size_--;
+  }
+
+  auto ClockReplacer::Size() -> size_t
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return curr_size_;
+  }
+
+} // namespace bustub
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <mutex> // NOLINT
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  /**
+   * ClockReplacer implements the CLOCK (second chance) policy.
+   *
+   * Every frame has a reference bit. The clock hand sweeps the frames in order, clearing set bits,
+   * and evicts the first evictable frame whose bit is already clear. Frames start with the bit
+   * clear, so a page touched only once is evicted on the first sweep that reaches it; Scan accesses
+   * never set it.
+   *
+   * An access to a tracked frame only sets its reference bit with a relaxed atomic store and does
+   * not take the latch. The caller must not evict or remove a frame while it is being accessed,
+   * which the buffer pool guarantees by pinning.
+   */
+  class ClockReplacer : public Replacer
+  {
+  public:
+    explicit ClockReplacer(size_t num_frames);
+
+    DISALLOW_COPY_AND_MOVE(ClockReplacer);
+
+    ~ClockReplacer() override = default;
+
+    auto Evict(frame_id_t *frame_id) -> bool override;
+
+    void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                      page_id_t page_id = INVALID_PAGE_ID) override;
+
+    void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+    void Remove(frame_id_t frame_id) override;
+
+    auto Size() -> size_t override;
+
+  private:
+    struct FrameInfo
+    {
+      std::atomic<bool> tracked{false};    // 只在持有 latch_ 时修改
+      std::atomic<bool> referenced{false}; // 访问时无锁置位，时钟指针经过时清除
+      bool is_evictable{false};            // 受 latch_ 保护
+    };
+
+    size_t replacer_size_;
+    size_t hand_{0};      // 时钟指针
+    size_t curr_size_{0}; // 可驱逐的帧数量
+    std::mutex latch_;
+
+    std::vector<FrameInfo> frames_;
+  };
+
+} // namespace bustub
@@ -0,0 +1,274 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_extendible_hash_table.cpp
+//
+// Identification: src/container/disk/hash/disk_extendible_hash_table.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <mutex>  // NOLINT
+#include <stdexcept>
+
+#include "container/disk/hash/disk_extendible_hash_table.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * @brief 固定一个页面，析构时自动取消固定
+ *
+ * 修改过页面内容后要调用 MarkDirty，取消固定时缓冲池才会在淘汰前写回它。
+ */
+class PinnedPage {
+ public:
+  PinnedPage(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {
+    if (page_ == nullptr) {
+      throw std::runtime_error("buffer pool has no free frame");
+    }
+  }
+
+  ~PinnedPage() { bpm_->UnpinPage(page_->GetPageId(), dirty_); }
+
+  DISALLOW_COPY_AND_MOVE(PinnedPage);
+
+  template <typename T>
+  auto As() -> T * { return reinterpret_cast<T *>(page_->GetData()); }
+
+  void MarkDirty() { dirty_ = true; }
+
+ private:
+  BufferPoolManager *bpm_;
+  Page *page_;
+  bool dirty_{false};
+};
+
+}  // namespace
+
+/**
+ * @brief DiskExtendibleHashTable 类的构造函数
+ *
+ * header_page_id 有效时打开已有的表，否则创建一个只有头页面的新表。
+ * 目录页面和桶页面的最大深度与大小保存在各自的页面中，重新打开时无需再次指定。
+ */
+template <typename K, typename V, typename Hash>
+DiskExtendibleHashTable<K, V, Hash>::DiskExtendibleHashTable(BufferPoolManager *bpm, page_id_t header_page_id,
+                                                             const Hash &hash_fn, uint32_t header_max_depth,
+                                                             uint32_t directory_max_depth, uint32_t bucket_max_size)
+    : bpm_(bpm),
+      hash_fn_(hash_fn),
+      header_page_id_(header_page_id),
+      directory_max_depth_(directory_max_depth),
+      bucket_max_size_(bucket_max_size) {
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    PinnedPage header_page(bpm_, bpm_->NewPage(&header_page_id_));
+    header_page.As<ExtendibleHTableHeaderPage>()->Init(header_max_depth);
+    header_page.MarkDirty();
+  }
+}
+
+template <typename K, typename V, typename Hash>
+auto DiskExtendibleHashTable<K, V, Hash>::GetHeaderPageId() const -> page_id_t { return header_page_id_; }
+
+/**
+ * @brief 查找指定键的值：依次读取头页面、目录页面和桶页面
+ */
+template <typename K, typename V, typename Hash>
+auto DiskExtendibleHashTable<K, V, Hash>::Find(const K &key, V &value) -> bool {
+  uint32_t hash = HashOf(key);
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  PinnedPage header_page(bpm_, bpm_->FetchPage(header_page_id_));
+  auto *header = header_page.As<ExtendibleHTableHeaderPage>();
+  page_id_t directory_page_id = header->GetDirectoryPageId(header->HashToDirectoryIndex(hash));
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  PinnedPage directory_page(bpm_, bpm_->FetchPage(directory_page_id));
+  auto *directory = directory_page.As<ExtendibleHTableDirectoryPage>();
+  PinnedPage bucket_page(bpm_, bpm_->FetchPage(directory->GetBucketPageId(directory->HashToBucketIndex(hash))));
+  return bucket_page.As<BucketPage>()->Lookup(key, value);
+}
+
+/**
+ * @brief 插入键值对
+ *
+ * 桶已满时分裂它，局部深度等于全局深度时先在目录页面内扩展目录，然后重试。
+ * 每次分裂只修改目录页面、原桶页面和新桶页面。
+ */
+template <typename K, typename V, typename Hash>
+auto DiskExtendibleHashTable<K, V, Hash>::Insert(const K &key, const V &value) -> bool {
+  uint32_t hash = HashOf(key);
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  PinnedPage header_page(bpm_, bpm_->FetchPage(header_page_id_));
+  auto *header = header_page.As<ExtendibleHTableHeaderPage>();
+  uint32_t directory_idx = header->HashToDirectoryIndex(hash);
+  page_id_t directory_page_id = header->GetDirectoryPageId(directory_idx);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    directory_page_id = CreateDirectory(header, directory_idx);
+    header_page.MarkDirty();
+  }
+
+  PinnedPage directory_page(bpm_, bpm_->FetchPage(directory_page_id));
+  auto *directory = directory_page.As<ExtendibleHTableDirectoryPage>();
+  while (true) {
+    uint32_t bucket_idx = directory->HashToBucketIndex(hash);
+    PinnedPage bucket_page(bpm_, bpm_->FetchPage(directory->GetBucketPageId(bucket_idx)));
+    auto *bucket = bucket_page.As<BucketPage>();
+    if (bucket->Insert(key, value)) {
+      bucket_page.MarkDirty();
+      return true;
+    }
+
+    if (directory->GetLocalDepth(bucket_idx) == directory->GetGlobalDepth()) {
+      if (directory->GetGlobalDepth() == directory->GetMaxDepth()) {
+        return false;  // 目录已达最大深度，无法再分裂
+      }
+      directory->IncrGlobalDepth();
+    }
+    SplitBucket(directory, bucket_idx, bucket);
+    directory_page.MarkDirty();
+    bucket_page.MarkDirty();
+  }
+}
+
+/**
+ * @brief 删除指定键，并尽可能合并桶、收缩目录
+ */
+template <typename K, typename V, typename Hash>
+auto DiskExtendibleHashTable<K, V, Hash>::Remove(const K &key) -> bool {
+  uint32_t hash = HashOf(key);
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  PinnedPage header_page(bpm_, bpm_->FetchPage(header_page_id_));
+  auto *header = header_page.As<ExtendibleHTableHeaderPage>();
+  page_id_t directory_page_id = header->GetDirectoryPageId(header->HashToDirectoryIndex(hash));
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  PinnedPage directory_page(bpm_, bpm_->FetchPage(directory_page_id));
+  auto *directory = directory_page.As<ExtendibleHTableDirectoryPage>();
+  uint32_t bucket_idx = directory->HashToBucketIndex(hash);
+  PinnedPage bucket_page(bpm_, bpm_->FetchPage(directory->GetBucketPageId(bucket_idx)));
+  auto *bucket = bucket_page.As<BucketPage>();
+  if (!bucket->Remove(key)) {
+    return false;
+  }
+  bucket_page.MarkDirty();
+
+  uint32_t global_depth = directory->GetGlobalDepth();
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  MergeBuckets(directory, bucket_idx, bucket);
+  if (directory->GetGlobalDepth() != global_depth || directory->GetLocalDepth(bucket_idx) != local_depth) {
+    directory_page.MarkDirty();
+  }
+  return true;
+}
+
+/**
+ * @brief 创建一个目录页面，其中只有一个空桶
+ *
+ * @return page_id_t 新目录页面的 id
+ */
+template <typename K, typename V, typename Hash>
+auto DiskExtendibleHashTable<K, V, Hash>::CreateDirectory(ExtendibleHTableHeaderPage *header, uint32_t directory_idx)
+    -> page_id_t {
+  page_id_t directory_page_id;
+  page_id_t bucket_page_id;
+  PinnedPage directory_page(bpm_, bpm_->NewPage(&directory_page_id));
+  PinnedPage bucket_page(bpm_, bpm_->NewPage(&bucket_page_id));
+  bucket_page.As<BucketPage>()->Init(bucket_max_size_);
+  bucket_page.MarkDirty();
+
+  auto *directory = directory_page.As<ExtendibleHTableDirectoryPage>();
+  directory->Init(directory_max_depth_);
+  directory->SetBucketPageId(0, bucket_page_id);
+  directory_page.MarkDirty();
+
+  header->SetDirectoryPageId(directory_idx, directory_page_id);
+  return directory_page_id;
+}
+
+/**
+ * @brief 原地分裂桶
+ *
+ * 哈希值的分裂位为 1 的键值对移到新桶页面，其余留在原桶页面中。
+ * 指向原桶的槽位与 bucket_idx 的低 local_depth 位相同，其中分裂位为 1 的一半改指向新桶。
+ */
+template <typename K, typename V, typename Hash>
+void DiskExtendibleHashTable<K, V, Hash>::SplitBucket(ExtendibleHTableDirectoryPage *directory, uint32_t bucket_idx,
+                                                      BucketPage *bucket) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  uint32_t split_bit = 1U << local_depth;
+  page_id_t image_page_id;
+  PinnedPage image_page(bpm_, bpm_->NewPage(&image_page_id));
+  auto *image = image_page.As<BucketPage>();
+  image->Init(bucket->MaxSize());
+  for (uint32_t i = 0; i < bucket->Size();) {
+    if ((HashOf(bucket->KeyAt(i)) & split_bit) != 0) {
+      image->Append(bucket->KeyAt(i), bucket->ValueAt(i));
+      bucket->RemoveAt(i);  // 最后一个元素移到位置 i，不前进
+    } else {
+      i++;
+    }
+  }
+  image_page.MarkDirty();
+
+  for (uint32_t i = bucket_idx & (split_bit - 1); i < directory->Size(); i += split_bit) {
+    directory->SetLocalDepth(i, local_depth + 1);
+    if ((i & split_bit) != 0) {
+      directory->SetBucketPageId(i, image_page_id);
+    }
+  }
+}
+
+/**
+ * @brief 合并桶并收缩目录
+ *
+ * 把分裂镜像中的键值对移入当前桶，删除镜像页面，再把指向镜像的槽位改为指向当前桶。
+ * 与内存中的哈希表一样，只有合并后不超过半个桶时才合并，避免在边界附近反复分裂与合并。
+ */
+template <typename K, typename V, typename Hash>
+void DiskExtendibleHashTable<K, V, Hash>::MergeBuckets(ExtendibleHTableDirectoryPage *directory, uint32_t bucket_idx,
+                                                       BucketPage *bucket) {
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  while (directory->GetLocalDepth(bucket_idx) > 0) {
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = directory->GetSplitImageIndex(bucket_idx);
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    {
+      PinnedPage image_page(bpm_, bpm_->FetchPage(image_page_id));
+      auto *image = image_page.As<BucketPage>();
+      if (bucket->Size() + image->Size() > bucket->MaxSize() / 2) {
+        break;
+      }
+      for (uint32_t i = 0; i < image->Size(); i++) {
+        bucket->Append(image->KeyAt(i), image->ValueAt(i));
+      }
+    }
+    bpm_->DeletePage(image_page_id);
+
+    uint32_t stride = 1U << (local_depth - 1);
+    for (uint32_t i = bucket_idx & (stride - 1); i < directory->Size(); i += stride) {
+      directory->SetLocalDepth(i, local_depth - 1);
+      directory->SetBucketPageId(i, bucket_page_id);
+    }
+  }
+
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+}
+
+// ========================== 模板类显式实例化 ==========================
+template class DiskExtendibleHashTable<int, int>;
+template class DiskExtendibleHashTable<int64_t, int64_t>;
+template class DiskExtendibleHashTable<int, int, IntegerMixHash<int>>;
+
+}  // namespace bustub
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_extendible_hash_table.h
+//
+// Identification: src/include/container/disk/hash/disk_extendible_hash_table.h
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * disk_extendible_hash_table.h
+ *
+ * Implementation of a disk-resident hash table using extendible hashing, stored in pages of the
+ * buffer pool.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <shared_mutex>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+#include "storage/page/extendible_htable_bucket_page.h"
+#include "storage/page/extendible_htable_directory_page.h"
+#include "storage/page/extendible_htable_header_page.h"
+
+namespace bustub {
+
+/**
+ * DiskExtendibleHashTable is the disk-resident counterpart of ExtendibleHashTable. Every part of it
+ * lives in a buffer pool page:
+ *
+ *    header page  --(top bits of the hash)-->  directory pages  --(low bits)-->  bucket pages
+ *
+ * The header page id is all that is needed to reopen a table, so a restart does not rebuild it by
+ * re-inserting every key. A directory page is created the first time a key maps to it.
+ *
+ * Insert and Remove touch O(1) pages: the header, one directory and one bucket, plus the split
+ * image when a bucket is split or merged. Buckets are merged with their split image when together
+ * they fill at most half a page, with the same hysteresis as ExtendibleHashTable::Remove.
+ *
+ * The hash must be stable across restarts; only its low 32 bits are used. K and V must be
+ * trivially copyable.
+ *
+ * Concurrency: Find holds the table latch shared, Insert and Remove hold it exclusively.
+ */
+template <typename K, typename V, typename Hash = std::hash<K>>
+class DiskExtendibleHashTable {
+ public:
+  /**
+   * @brief Open the table rooted at header_page_id, or create a new one.
+   * @param bpm The buffer pool that stores the table's pages.
+   * @param header_page_id The header page of an existing table, or INVALID_PAGE_ID to create one.
+   * @param hash_fn The hasher for keys.
+   * @param header_max_depth The number of hash bits the header uses to pick a directory (new tables).
+   * @param directory_max_depth The max global depth of the directories this instance creates.
+   * @param bucket_max_size The max number of pairs in the buckets this instance creates.
+   */
+  explicit DiskExtendibleHashTable(BufferPoolManager *bpm, page_id_t header_page_id = INVALID_PAGE_ID,
+                                   const Hash &hash_fn = Hash(), uint32_t header_max_depth = HTABLE_HEADER_MAX_DEPTH,
+                                   uint32_t directory_max_depth = HTABLE_DIRECTORY_MAX_DEPTH,
+                                   uint32_t bucket_max_size = HTableBucketArraySize<K, V>());
+
+  DISALLOW_COPY_AND_MOVE(DiskExtendibleHashTable);
+
+  /** @brief Get the page id to reopen this table with. */
+  auto GetHeaderPageId() const -> page_id_t;
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool;
+
+  /**
+   * @brief Insert the given key-value pair; if the key exists its value is updated. A full bucket is
+   * split, doubling its directory first if needed.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   * @return False if the bucket is full and its directory is already at its max depth.
+   */
+  auto Insert(const K &key, const V &value) -> bool;
+
+  /**
+   * @brief Remove the given key, merging its bucket with the split image and shrinking the
+   * directory where possible.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool;
+
+ private:
+  using BucketPage = ExtendibleHTableBucketPage<K, V>;
+
+  /** @brief The 32-bit hash that both the header and the directories index by. */
+  inline auto HashOf(const K &key) const -> uint32_t { return static_cast<uint32_t>(hash_fn_(key)); }
+
+  /**
+   * @brief Create the directory for directory_idx of the header, with a single empty bucket.
+   * @return The page id of the new directory.
+   */
+  auto CreateDirectory(ExtendibleHTableHeaderPage *header, uint32_t directory_idx) -> page_id_t;
+
+  /**
+   * @brief Split the full bucket at bucket_idx, whose local depth is below the global depth. The
+   * bucket keeps the pairs whose new split bit is 0; the rest move to a new bucket page.
+   */
+  void SplitBucket(ExtendibleHTableDirectoryPage *directory, uint32_t bucket_idx, BucketPage *bucket);
+
+  /**
+   * @brief Merge the bucket at bucket_idx with its split image for as long as both have the same
+   * local depth and fit in half a bucket, deleting the image pages, then shrink the directory.
+   */
+  void MergeBuckets(ExtendibleHTableDirectoryPage *directory, uint32_t bucket_idx, BucketPage *bucket);
+
+  BufferPoolManager *bpm_;
+  Hash hash_fn_;
+  page_id_t header_page_id_;
+  uint32_t directory_max_depth_;
+  uint32_t bucket_max_size_;
+  std::shared_mutex latch_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.cpp
+//
+// Identification: src/common/epoch_manager.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/epoch_manager.h"
+
+#include <stdexcept>
+
+namespace bustub {
+
+namespace {
+
+// 每个线程的读者状态：占用的槽位与 Enter() 的嵌套层数，线程退出时归还槽位
+struct ThreadState {
+  EpochManager::Slot *slot_{nullptr};
+  size_t depth_{0};
+
+  ~ThreadState() {
+    if (slot_ != nullptr) {
+      EpochManager::Instance().ReleaseSlot(slot_);
+    }
+  }
+};
+
+thread_local ThreadState thread_state;
+
+}  // namespace
+
+auto EpochManager::Instance() -> EpochManager & {
+  static EpochManager instance;
+  return instance;
+}
+
+/**
+ * @brief 进入读区
+ *
+ * 把当前的全局纪元写入本线程的槽位，随后的全屏障保证：
+ * 要么回收者能看到这个槽位，要么本线程接下来的读取能看到回收者之前的摘除操作。
+ */
+void EpochManager::Enter() {
+  ThreadState &state = thread_state;
+  if (state.depth_++ > 0) {
+    return;  // 嵌套调用，外层已经固定了纪元
+  }
+  if (state.slot_ == nullptr) {
+    state.slot_ = AcquireSlot();
+  }
+  state.slot_->epoch_.store(global_epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+/**
+ * @brief 退出读区：最外层退出时清空槽位
+ */
+void EpochManager::Exit() {
+  ThreadState &state = thread_state;
+  if (--state.depth_ > 0) {
+    return;
+  }
+  state.slot_->epoch_.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief 推进全局纪元，返回调用前摘除的对象所属的纪元
+ */
+auto EpochManager::RetireEpoch() -> uint64_t { return global_epoch_.fetch_add(1, std::memory_order_seq_cst); }
+
+/**
+ * @brief 返回所有读者中最小的纪元，没有读者时返回当前纪元
+ */
+auto EpochManager::OldestActiveEpoch() const -> uint64_t {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t oldest = global_epoch_.load(std::memory_order_seq_cst);
+  size_t high_water = high_water_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < high_water; i++) {
+    uint64_t epoch = slots_[i].epoch_.load(std::memory_order_acquire);
+    if (epoch != 0 && epoch < oldest) {
+      oldest = epoch;
+    }
+  }
+  return oldest;
+}
+
+void EpochManager::ReleaseSlot(Slot *slot) {
+  slot->epoch_.store(0, std::memory_order_release);
+  slot->in_use_.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief 为新线程分配一个空闲槽位，优先复用已退出线程的槽位
+ */
+auto EpochManager::AcquireSlot() -> Slot * {
+  for (size_t i = 0; i < MAX_THREADS; i++) {
+    bool expected = false;
+    if (!slots_[i].in_use_.load(std::memory_order_relaxed) &&
+        slots_[i].in_use_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      size_t high_water = high_water_.load(std::memory_order_relaxed);
+      while (high_water < i + 1 && !high_water_.compare_exchange_weak(high_water, i + 1, std::memory_order_acq_rel)) {
+      }
+      return &slots_[i];
+    }
+  }
+  throw std::runtime_error("Too many threads in EpochManager");
+}
+
+}  // namespace bustub
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// epoch_manager.h
+//
+// Identification: src/include/common/epoch_manager.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * EpochManager implements epoch-based reclamation for readers that traverse a data structure
+ * without holding its latch, such as the optimistic Find of ExtendibleHashTable.
+ *
+ * A reader wraps its traversal in an EpochGuard, which publishes the current global epoch in a
+ * slot owned by the reader's thread. A writer that has unlinked an object calls RetireEpoch() and
+ * tags the object with the returned epoch; the object may be freed once OldestActiveEpoch() is
+ * greater than its tag, because every reader that could still have seen it has finished.
+ *
+ * The manager is process-wide, so a thread owns one slot no matter how many tables it reads.
+ * Data structures keep their own retired lists and free them against OldestActiveEpoch().
+ */
+class EpochManager {
+ public:
+  /** The maximum number of threads that can be inside an EpochGuard at the same time. */
+  static constexpr size_t MAX_THREADS = 1024;
+
+  /** A reader slot. Each one sits on its own cache line so readers never share a line. */
+  struct alignas(64) Slot {
+    std::atomic<uint64_t> epoch_{0};  // The epoch pinned by the owning thread, 0 if not reading
+    std::atomic<bool> in_use_{false};
+  };
+
+  DISALLOW_COPY_AND_MOVE(EpochManager);
+
+  /** @brief Get the process-wide epoch manager. */
+  static auto Instance() -> EpochManager &;
+
+  /** @brief Pin the current epoch for the calling thread. Calls may nest. */
+  void Enter();
+
+  /** @brief Unpin the epoch pinned by the matching Enter(). */
+  void Exit();
+
+  /**
+   * @brief Advance the global epoch.
+   * @return The epoch to tag objects with that were unlinked before this call.
+   */
+  auto RetireEpoch() -> uint64_t;
+
+  /** @brief Get the smallest epoch pinned by any reader, or the current epoch if no one is reading. */
+  auto OldestActiveEpoch() const -> uint64_t;
+
+  /** @brief Release the slot of a thread that is exiting. */
+  void ReleaseSlot(Slot *slot);
+
+ private:
+  EpochManager() = default;
+
+  auto AcquireSlot() -> Slot *;
+
+  std::atomic<uint64_t> global_epoch_{1};
+  std::atomic<size_t> high_water_{0};  // Slots at or above this index have never been used
+  std::array<Slot, MAX_THREADS> slots_;
+};
+
+/**
+ * RAII guard for an epoch-protected read section.
+ */
+class EpochGuard {
+ public:
+  EpochGuard() { EpochManager::Instance().Enter(); }
+  ~EpochGuard() { EpochManager::Instance().Exit(); }
+
+  DISALLOW_COPY_AND_MOVE(EpochGuard);
+};
+
+}  // namespace bustub
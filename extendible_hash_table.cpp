@@ -1,7 +1,19 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
 #include <functional>
 #include <list>
+#include <stdexcept>
+#include <thread>  // NOLINT
 #include <utility>
 
 #include "container/hash/extendible_hash_table.h"
@@ -11,6 +23,93 @@
 
 namespace bustub {
 
+namespace {
+
+/**
+ * @brief ֻӳļʱӳ
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("cannot open hash table image " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error("cannot stat hash table image " + path);
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data_ == MAP_FAILED) {
+      throw std::runtime_error("cannot map hash table image " + path);
+    }
+    if (size_ > 0) {
+      madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+  }
+
+  ~MappedFile() {
+    if (size_ > 0) {
+      munmap(data_, size_);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(MappedFile);
+
+  auto Data() const -> const char * { return static_cast<const char *>(data_); }
+  auto Size() const -> size_t { return size_; }
+
+ private:
+  void *data_{nullptr};
+  size_t size_{0};
+};
+
+/**
+ * @brief  n ȷֲļʹĿ¼ﵽȫ
+ * 
+ * ȫĲλƽռʾΪ d ʱÿλļƷ
+ * ֵ n / 2^d Ĳɷֲȡ bucket_size ĲλС RESERVE_OVERFLOW_SLOTS Сȡ
+ * 
+ * @param n 
+ * @param bucket_size ͰĴС
+ * @param max_depth ȵ
+ * @return int Ƶȫȣ max_depth
+ */
+auto ExpectedGlobalDepth(size_t n, size_t bucket_size, int max_depth) -> int {
+  constexpr double RESERVE_OVERFLOW_SLOTS = 0.1;
+  for (int depth = 0; depth < max_depth; depth++) {
+    double slots = std::ldexp(1.0, depth);
+    double mean = static_cast<double>(n) / slots;
+    if (mean > static_cast<double>(bucket_size)) {
+      continue;
+    }
+    if (mean == 0) {
+      return depth;
+    }
+    // P(X > bucket_size) bucket_size + 1 ʼۼӣֵ bucket_size ʱݼ
+    double tail = 0;
+    for (size_t k = bucket_size + 1; k <= bucket_size + 1000; k++) {
+      auto x = static_cast<double>(k);
+      double term = std::exp(-mean + x * std::log(mean) - std::lgamma(x + 1));
+      tail += term;
+      if (term < tail * 1e-12) {
+        break;
+      }
+    }
+    if (slots * tail < RESERVE_OVERFLOW_SLOTS) {
+      return depth;
+    }
+  }
+  return max_depth;
+}
+
+}  // namespace
+
 /**
  * @brief ExtendibleHashTable Ĺ캯
  * 
@@ -18,11 +117,33 @@ namespace bustub {
  * 
  * @tparam K 
  * @tparam V ֵ
+ * @tparam Hash Ĺϣ
  * @param bucket_size ÿͰԪ
+ * @param hash_fn Ĺϣ
+ * @param memory_policy Ŀ¼Ͱ slab ڴĲԣҳNUMA ã
  */
-template <typename K, typename V>
-ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
-    : bucket_size_(bucket_size), dir_{std::make_shared<Bucket>(bucket_size, 0)} {
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::ExtendibleHashTable(size_t bucket_size, const Hash &hash_fn,
+                                                     const MemoryPolicy &memory_policy)
+    : bucket_size_(bucket_size),
+      hash_fn_(hash_fn),
+      max_bucket_capacity_(bucket_size),
+      memory_policy_(memory_policy),
+      pool_(bucket_size, memory_policy) {
+  auto *dir = new Directory(0, memory_policy_);
+  dir->slots_[0].store(pool_.Allocate(0, 0, bucket_size_), std::memory_order_relaxed);
+  dir_.store(dir, std::memory_order_release);
+}
+
+/**
+ * @brief ExtendibleHashTable 
+ * 
+ * ͷĿ¼Ͱ pool_ ͳһͷš
+ */
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::~ExtendibleHashTable() {
+  delete dir_.load(std::memory_order_relaxed);
+  delete migrating_from_;
 }
 
 /**
@@ -33,10 +154,9 @@ ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
  * @param key Ҫϣļ
  * @return size_t ؼĿ¼
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
-  int mask = (1 << global_depth_) - 1;
-  return std::hash<K>()(key) & mask;
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::IndexOf(const K &key) -> size_t {
+  return IndexOfHash(hash_fn_(key));
 }
 
 /**
@@ -44,9 +164,9 @@ auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
  * 
  * @return int صǰȫ
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::GetGlobalDepth() const -> int {
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return global_depth_;
 }
 
@@ -56,10 +176,10 @@ auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
  * @param dir_index Ŀ¼
  * @return int ָͰľֲ
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return dir_[dir_index]->GetDepth();
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::GetLocalDepth(int dir_index) const -> int {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  return BucketAt(dir_index)->GetDepth();
 }
 
 /**
@@ -67,12 +187,47 @@ auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
  * 
  * @return int Ͱ
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::GetNumBuckets() const -> int {
+  std::shared_lock<std::shared_mutex> lock(latch_);
   return num_buckets_;
 }
 
+/**
+ * @brief ͳƼ
+ * 
+ * ̷߳ɢڲͬĻϣǼͰƽռֳͰ㡣
+ * 
+ * @return Stats ͳݵĿ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::GetStats() const -> Stats {
+  Stats stats{};
+  stats.finds = stats_.finds_.Load();
+  stats.hits = stats_.hits_.Load();
+  stats.misses = stats.finds - stats.hits;
+  stats.inserts = stats_.inserts_.Load();
+  stats.splits = stats_.splits_.Load();
+  stats.directory_doublings = stats_.doublings_.Load();
+  stats.bucket_growths = stats_.growths_.Load();
+  stats.latch_contended = stats_.latch_.contended_.Load();
+  stats.latch_wait_ns = stats_.latch_.wait_ns_.Load();
+
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  Directory *dir = dir_.load(std::memory_order_relaxed);
+  size_t pairs = 0;
+  size_t capacity = 0;
+  for (size_t i = 0; i < dir->slots_.size(); i++) {
+    const Bucket *bucket = pool_.Get(dir->Lookup(i));
+    if (i < (1UL << bucket->GetDepth())) {
+      pairs += bucket->GetSize();
+      capacity += bucket->GetCapacity();
+    }
+  }
+  stats.avg_bucket_occupancy = static_cast<double>(pairs) / static_cast<double>(capacity);
+  return stats;
+}
+
 /**
  * @brief ֵָ
  * 
@@ -80,10 +235,39 @@ auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
  * @param value 洢ҵֵ
  * @return true ҵ true򷵻 false
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return dir_[IndexOf(key)]->Find(key, value);
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Find(const K &key, V &value) -> bool {
+  if constexpr (OPTIMISTIC_FIND) {
+    // ֹ۶κҲдκιڴ棬Ͱİ汾У
+    // Ԫ֤ȡڼĿ¼Ͱᱻͷ
+    size_t hash = hash_fn_(key);
+    EpochGuard guard;
+    for (size_t attempt = 0;; attempt++) {
+      Directory *dir = dir_.load(std::memory_order_acquire);
+      size_t mask = (1UL << dir->global_depth_) - 1;
+      Bucket *bucket = pool_.Get(dir->Lookup(hash & mask));
+      bool found;
+      if (bucket->OptimisticFind(key, hash, value, &found)) {
+        stats_.finds_.Add();
+        if (found) {
+          stats_.hits_.Add();
+        }
+        return found;
+      }
+      if (attempt > 64) {
+        std::this_thread::yield(); // д߳Ͱʱ̣ܶʧ˵д߱
+      }
+    }
+  } else {
+    size_t hash = hash_fn_(key);
+    auto lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+    bool found = BucketAt(IndexOfHash(hash))->Find(key, hash, value);
+    stats_.finds_.Add();
+    if (found) {
+      stats_.hits_.Add();
+    }
+    return found;
+  }
 }
 
 /**
@@ -92,10 +276,24 @@ auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
  * @param key ҪƳļ
  * @return true ɹƳ true򷵻 false
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return dir_[IndexOf(key)]->Remove(key);
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Remove(const K &key) -> bool {
+  size_t hash = hash_fn_(key);
+  {
+    auto lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+    size_t index = IndexOfHash(hash);
+    if (!BucketAt(index)->Remove(key, hash)) {
+      return false;
+    }
+    if (!ShouldMerge(index)) {
+      return true;
+    }
+  }
+
+  // ҪϲͰʱΪռĿ¼MergeBuckets ¼
+  auto lock = AcquireLatch<std::unique_lock<std::shared_mutex>>(latch_, stats_.latch_);
+  MergeBuckets(IndexOfHash(hash));
+  return true;
 }
 
 /**
@@ -106,146 +304,1512 @@ auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
  * @param key Ҫļ
  * @param value Ҫֵ
  */
-template <typename K, typename V>
-void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
-  std::scoped_lock<std::mutex> lock(latch_);
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Insert(const K &key, const V &value) {
+  bool inserted;
+  Put(key, value, true, &inserted);
+}
+
+/**
+ * @brief ϣвֵԣֵƶǸ
+ * 
+ * @param key Ҫļ
+ * @param value Ҫֵ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Insert(K &&key, V &&value) {
+  bool inserted;
+  Put(std::move(key), std::move(value), true, &inserted);
+}
+
+/**
+ * @brief ֵԣѴʱ޸ԭеֵ
+ * 
+ * @param key Ҫļ
+ * @param value ҪֵֻвɹʱŻᱻƶ
+ * @return true ɹѴʱ false
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::EmplaceValue(const K &key, V &&value) -> bool {
+  bool inserted;
+  Put(key, std::move(value), false, &inserted);
+  return inserted;
+}
+
+/**
+ * @brief ֵԣѴʱԭеֵ
+ * 
+ * @param key Ҫļ
+ * @param value Ҫֵ
+ * @return V& бֵ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::InsertOrAssign(const K &key, V value) -> V & {
+  bool inserted;
+  return Put(key, std::move(value), true, &inserted);
+}
+
+/**
+ * @brief ֵָָбֵָ
+ * 
+ * @param key Ҫҵļ
+ * @return V* бֵδҵʱ nullptr
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::FindPtr(const K &key) -> V * {
+  size_t hash = hash_fn_(key);
+  auto lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+  V *stored = BucketAt(IndexOfHash(hash))->FindPtr(key, hash);
+  stats_.finds_.Add();
+  if (stored != nullptr) {
+    stats_.hits_.Add();
+  }
+  return stored;
+}
+
+/**
+ * @brief ¼ֵԣвӿն
+ * 
+ * ֵתͰУֵᱻƶͰʱͰĲ԰ȫؽ·ٴת
+ * 
+ * @param key Ҫļ
+ * @param value Ҫֵ
+ * @param assign ѴʱǷ񸲸ԭеֵ
+ * @param inserted Ƿµļֵ
+ * @return V& бֵ
+ */
+template <typename K, typename V, typename Hash>
+template <typename KArg, typename VArg>
+auto ExtendibleHashTable<K, V, Hash>::Put(KArg &&key, VArg &&value, bool assign, bool *inserted) -> V & {
+  size_t hash = hash_fn_(key);
+  stats_.inserts_.Add();
+  {
+    // ·Ͱδʱֻ蹲Ŀ¼Ͱ
+    auto lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+    MigrateStep();
+    V *stored =
+        BucketAt(IndexOfHash(hash))->Put(std::forward<KArg>(key), hash, std::forward<VArg>(value), assign, inserted);
+    if (stored != nullptr) {
+      return *stored;
+    }
+  }
+  return PutExclusive(std::forward<KArg>(key), hash, std::forward<VArg>(value), assign, inserted);
+}
 
+/**
+ * @brief ·
+ * 
+ * ͰҪռĿ¼Ͱ߳̿Ѿ˷ѣԼɣ
+ * 
+ * @param key Ҫļ
+ * @param hash Ĺϣֵ
+ * @param value Ҫֵ
+ * @param assign ѴʱǷ񸲸ԭеֵ
+ * @param inserted Ƿµļֵ
+ * @return V& бֵ
+ */
+template <typename K, typename V, typename Hash>
+template <typename KArg, typename VArg>
+auto ExtendibleHashTable<K, V, Hash>::PutExclusive(KArg &&key, size_t hash, VArg &&value, bool assign, bool *inserted)
+    -> V & {
+  auto lock = AcquireLatch<std::unique_lock<std::shared_mutex>>(latch_, stats_.latch_);
+  EndMigration(false);
   while (true) {
-    size_t index = IndexOf(key);
-    auto bucket = dir_[index];
+    size_t index = IndexOfHash(hash);
+    Bucket *bucket = BucketAt(index);
 
-    if (bucket->Insert(key, value)) {
-      return; // ɹ
+    V *stored = bucket->Put(std::forward<KArg>(key), hash, std::forward<VArg>(value), assign, inserted);
+    if (stored != nullptr) {
+      return *stored; // ɹ
     }
 
     if (global_depth_ == bucket->GetDepth()) {
+      if (ShouldGrow(bucket)) {
+        GrowBucket(index); // ȵͰչĿ¼
+        continue;
+      }
       DirectoryExtension(); // չĿ¼
       global_depth_++;
     }
-    SplitTheBucket(key); // Ͱ
+    SplitTheBucket(index); // ͰĿ¼չ index ָͬһͰ
+  }
+}
+
+/**
+ * @brief 
+ * 
+ * ÿ BATCH_GROUP_SIZE Ϊһ飬
+ *    1. ϣԤȡĿ¼λ
+ *    2. ȡλеͰָ벢ԤȡͰıǩ飻
+ *    3. ̽Ͱ
+ * һĻȱʧصеȴ
+ * 
+ * @param keys Ҫҵļ
+ * @param count 
+ * @param values 洢ҵֵ
+ * @param found ÿǷҵ
+ * @return size_t ҵļ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::FindBatch(const K *keys, size_t count, V *values, std::vector<bool> *found)
+    -> size_t {
+  found->assign(count, false);
+  // ֹ֧۶ֻһιĿ¼
+  std::shared_lock<std::shared_mutex> lock(latch_, std::defer_lock);
+  if constexpr (!OPTIMISTIC_FIND) {
+    lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+  }
+  EpochGuard guard;
+
+  size_t num_found = 0;
+  size_t hashes[BATCH_GROUP_SIZE];
+  Bucket *buckets[BATCH_GROUP_SIZE];
+  for (size_t begin = 0; begin < count; begin += BATCH_GROUP_SIZE) {
+    size_t group_size = std::min(BATCH_GROUP_SIZE, count - begin);
+    Directory *dir = dir_.load(std::memory_order_acquire);
+    size_t mask = dir->slots_.size() - 1;
+    for (size_t i = 0; i < group_size; i++) {
+      hashes[i] = hash_fn_(keys[begin + i]);
+      __builtin_prefetch(&dir->slots_[hashes[i] & mask]);
+    }
+    for (size_t i = 0; i < group_size; i++) {
+      buckets[i] = pool_.Get(dir->Lookup(hashes[i] & mask));
+      buckets[i]->PrefetchTags();
+    }
+    for (size_t i = 0; i < group_size; i++) {
+      const K &key = keys[begin + i];
+      bool hit;
+      if constexpr (OPTIMISTIC_FIND) {
+        // д߳ͻʱͰѱѣ˻صͨ Find
+        if (!buckets[i]->OptimisticFind(key, hashes[i], values[begin + i], &hit)) {
+          hit = Find(key, values[begin + i]);
+        }
+      } else {
+        hit = buckets[i]->Find(key, hashes[i], values[begin + i]);
+      }
+      if (hit) {
+        (*found)[begin + i] = true;
+        num_found++;
+      }
+    }
+  }
+  stats_.finds_.Add(count);
+  stats_.hits_.Add(num_found);
+  return num_found;
+}
+
+/**
+ * @brief 
+ * 
+ * һιĿ¼ڰ FindBatch ķʽԤȡ롣
+ * һͰʣļֵ԰˳ͨĲ·֤ͬһֵЧ
+ * 
+ * @param keys Ҫļ
+ * @param values Ҫֵ
+ * @param count ֵԵ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::InsertBatch(const K *keys, const V *values, size_t count) {
+  size_t hashes[BATCH_GROUP_SIZE];
+  Bucket *buckets[BATCH_GROUP_SIZE];
+  size_t next = 0;  // һδļֵ
+  {
+    auto lock = AcquireLatch<std::shared_lock<std::shared_mutex>>(latch_, stats_.latch_);
+    Directory *dir = dir_.load(std::memory_order_relaxed);
+    size_t mask = dir->slots_.size() - 1;
+    bool bucket_full = false;
+    for (size_t begin = 0; begin < count && !bucket_full; begin += BATCH_GROUP_SIZE) {
+      size_t group_size = std::min(BATCH_GROUP_SIZE, count - begin);
+      MigrateStep();
+      for (size_t i = 0; i < group_size; i++) {
+        hashes[i] = hash_fn_(keys[begin + i]);
+        __builtin_prefetch(&dir->slots_[hashes[i] & mask]);
+      }
+      for (size_t i = 0; i < group_size; i++) {
+        buckets[i] = pool_.Get(dir->Lookup(hashes[i] & mask));
+        buckets[i]->PrefetchTags();
+      }
+      for (size_t i = 0; i < group_size; i++) {
+        if (!buckets[i]->Insert(keys[begin + i], hashes[i], values[begin + i])) {
+          bucket_full = true;
+          break;
+        }
+        next = begin + i + 1;
+      }
+    }
+  }
+  stats_.inserts_.Add(next);
+  for (; next < count; next++) {
+    Insert(keys[next], values[next]);
+  }
+}
+
+/**
+ * @brief װصձ
+ * 
+ * ȸмĹϣֱֵյĿ¼ȫȡʹÿλֵ bucket_size_ Сֵ
+ * ԵϰѼ֮ͲһͰֵܲλϲΪֲȸ͵ͬһͰ
+ * ֮ÿͰֻһβֱмĿ¼չͰѡ
+ * ظļ̫ࡢκȶֲʱ˻ InsertBatch
+ * 
+ * @param keys Ҫļ
+ * @param values Ҫֵ
+ * @param count ֵԵ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::BulkLoad(const K *keys, const V *values, size_t count) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  if (count == 0 || num_buckets_ != 1 || BucketAt(0)->GetSize() != 0) {
+    lock.unlock();
+    InsertBatch(keys, values, count);
+    return;
+  }
+
+  std::vector<size_t> hashes(count);
+  for (size_t i = 0; i < count; i++) {
+    hashes[i] = hash_fn_(keys[i]);
+  }
+  int global_depth = 0;
+  while ((bucket_size_ << global_depth) < count) {
+    global_depth++;
+  }
+  int max_depth = global_depth + BULK_LOAD_EXTRA_DEPTH;
+  std::vector<size_t> counts;
+  while (true) {
+    counts.assign(1UL << global_depth, 0);
+    size_t mask = counts.size() - 1;
+    for (size_t hash : hashes) {
+      counts[hash & mask]++;
+    }
+    if (*std::max_element(counts.begin(), counts.end()) <= bucket_size_) {
+      break;
+    }
+    if (++global_depth > max_depth) {
+      lock.unlock();
+      InsertBatch(keys, values, count);
+      return;
+    }
+  }
+
+  // depths[i] ΪԲλ i Ϊ淶λͰľֲȣ-1 ʾλ i ѲȵͰ
+  std::vector<int> depths(counts.size(), global_depth);
+  for (int depth = global_depth; depth > 0; depth--) {
+    size_t half = 1UL << (depth - 1);
+    for (size_t i = 0; i < half; i++) {
+      if (depths[i] == depth && depths[i + half] == depth && counts[i] + counts[i + half] <= bucket_size_) {
+        counts[i] += counts[i + half];
+        depths[i] = depth - 1;
+        depths[i + half] = -1;
+      }
+    }
+  }
+
+  auto *dir = new Directory(global_depth, memory_policy_);
+  for (size_t i = 0; i < depths.size(); i++) {
+    if (depths[i] < 0) {
+      continue;
+    }
+    uint32_t bucket = pool_.Allocate(depths[i], i, bucket_size_);
+    for (size_t slot = i; slot < dir->slots_.size(); slot += 1UL << depths[i]) {
+      dir->slots_[slot].store(bucket, std::memory_order_relaxed);
+    }
+  }
+  size_t mask = dir->slots_.size() - 1;
+  for (size_t i = 0; i < count; i++) {
+    pool_.Get(dir->slots_[hashes[i] & mask].load(std::memory_order_relaxed))->Insert(keys[i], hashes[i], values[i]);
+  }
+  ReplaceDirectory(dir);
+}
+
+/**
+ * @brief Ϊ n ֵԤչĿ¼Ͱ
+ * 
+ * ȰͰ𼶷ѵƽռΪ RESERVE_LOAD_PERCENT% ȣķװͰ
+ * ͰԶģٰĿ¼չ ExpectedGlobalDepth Ƶȣ
+ * ֮Ĳ벻ҪչĿ¼òʱḶֹ́۶κʱ̶ܶȷݡ
+ * 
+ * @param n ԤƵļֵ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Reserve(size_t n) {
+  int depth = ExpectedGlobalDepth(n, bucket_size_, MAX_IMAGE_DEPTH);
+  if (static_cast<uint32_t>(depth) >= MAX_IMAGE_DEPTH) {
+    throw std::runtime_error("cannot reserve " + std::to_string(n) + " pairs");
+  }
+  size_t per_bucket = std::max<size_t>(bucket_size_ * RESERVE_LOAD_PERCENT / 100, 1);
+  int split_depth = 0;
+  while ((per_bucket << (split_depth + 1)) <= n && split_depth < depth) {
+    split_depth++;
+  }
+
+  auto lock = AcquireLatch<std::unique_lock<std::shared_mutex>>(latch_, stats_.latch_);
+  // 𼶷ѣ d ֻΪ d - 1 ͰʱĿ¼ͰһÿηֻдٵĲλ
+  for (int d = 1; d <= split_depth; d++) {
+    if (global_depth_ < d) {
+      DirectoryExtension();
+      global_depth_++;
+    }
+    EndMigration(true);
+    for (size_t i = 0; i < (1UL << (d - 1)); i++) {
+      if (BucketAt(i)->GetDepth() < d) {
+        SplitTheBucket(i);
+      }
+    }
+  }
+  while (global_depth_ < depth) {
+    DirectoryExtension();
+    global_depth_++;
+  }
+  EndMigration(true);
+}
+
+/**
+ * @brief Ͱ
+ * 
+ * @param max_capacity Ͱ bucket_size_ ʱ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::SetMaxBucketCapacity(size_t max_capacity) {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  max_bucket_capacity_ = std::max(max_capacity, bucket_size_);
+}
+
+/**
+ * @brief дһƾļ
+ * 
+ * ļΪ ImageHeaderͰűʾĿ¼ÿͰ ImageBucketHeader ԭʼ顣
+ * Ͱ淶λ;ֲλΪλǸλһγֵ˳š
+ * 
+ * @param path Ҫдļ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::SaveImage(const std::string &path) const {
+  if constexpr (!IMAGE_SUPPORTED) {
+    throw std::runtime_error("hash table image requires trivially copyable keys and values");
+  } else {
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    Directory *dir = dir_.load(std::memory_order_relaxed);
+    std::vector<uint32_t> ordinals(dir->slots_.size());
+    std::vector<const Bucket *> buckets;
+    for (size_t i = 0; i < dir->slots_.size(); i++) {
+      const Bucket *bucket = pool_.Get(dir->Lookup(i));
+      size_t canonical = i & ((1UL << bucket->GetDepth()) - 1);
+      if (canonical == i) {
+        ordinals[i] = buckets.size();
+        buckets.push_back(bucket);
+      } else {
+        ordinals[i] = ordinals[canonical];
+      }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw std::runtime_error("cannot open hash table image " + path);
+    }
+    ImageHeader header{IMAGE_MAGIC,
+                       sizeof(K),
+                       sizeof(V),
+                       bucket_size_,
+                       static_cast<uint32_t>(dir->global_depth_),
+                       static_cast<uint32_t>(buckets.size())};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(ordinals.data()), ordinals.size() * sizeof(uint32_t));
+    for (const Bucket *bucket : buckets) {
+      bucket->WriteImage(out);
+    }
+    out.flush();
+    if (!out) {
+      throw std::runtime_error("failed to write hash table image " + path);
+    }
+  }
+}
+
+/**
+ * @brief  SaveImage дľ滻ȫ
+ * 
+ * ļֻӳ䣬УͷȡĿ¼ÿԪصĹϣǩ
+ * ٷͰ memcpy ÿͰ飬¼ϣȽϼĿ¼һνմС
+ * 
+ * @param path Ҫȡļ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::LoadImage(const std::string &path) {
+  if constexpr (!IMAGE_SUPPORTED) {
+    throw std::runtime_error("hash table image requires trivially copyable keys and values");
+  } else {
+    MappedFile file(path);
+    const char *data = file.Data();
+    size_t size = file.Size();
+    auto mismatch = [&path]() { return std::runtime_error("hash table image " + path + " does not match the table"); };
+
+    ImageHeader header;
+    if (size < sizeof(header)) {
+      throw mismatch();
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic_ != IMAGE_MAGIC || header.key_size_ != sizeof(K) || header.value_size_ != sizeof(V) ||
+        header.bucket_size_ != bucket_size_ || header.global_depth_ >= MAX_IMAGE_DEPTH ||
+        header.num_buckets_ == 0 || header.num_buckets_ > (1UL << header.global_depth_)) {
+      throw mismatch();
+    }
+    size_t offset = sizeof(header);
+    size_t dir_size = 1UL << header.global_depth_;
+    if (size - offset < dir_size * sizeof(uint32_t)) {
+      throw mismatch();
+    }
+    std::vector<uint32_t> ordinals(dir_size);
+    memcpy(ordinals.data(), data + offset, dir_size * sizeof(uint32_t));
+    offset += dir_size * sizeof(uint32_t);
+
+    // УͰ֤֮ķ䲻;ʧ
+    constexpr size_t ITEM_SIZE = sizeof(uint8_t) + sizeof(K) + sizeof(V) + sizeof(size_t);
+    std::vector<ImageBucketHeader> bucket_headers(header.num_buckets_);
+    std::vector<size_t> bucket_offsets(header.num_buckets_);
+    for (auto &bucket_header : bucket_headers) {
+      if (size - offset < sizeof(bucket_header)) {
+        throw mismatch();
+      }
+      memcpy(&bucket_header, data + offset, sizeof(bucket_header));
+      offset += sizeof(bucket_header);
+      if (bucket_header.depth_ > header.global_depth_ || bucket_header.prefix_ >= (1UL << bucket_header.depth_) ||
+          bucket_header.count_ > max_bucket_capacity_ || size - offset < bucket_header.count_ * ITEM_SIZE ||
+          !Bucket::CheckImage(data + offset, bucket_header.count_, bucket_header.depth_, bucket_header.prefix_)) {
+        throw mismatch();
+      }
+      bucket_offsets[&bucket_header - bucket_headers.data()] = offset;
+      offset += bucket_header.count_ * ITEM_SIZE;
+    }
+    for (size_t i = 0; i < dir_size; i++) {
+      if (ordinals[i] >= header.num_buckets_) {
+        throw mismatch();
+      }
+      const ImageBucketHeader &bucket_header = bucket_headers[ordinals[i]];
+      if ((i & ((1UL << bucket_header.depth_) - 1)) != bucket_header.prefix_) {
+        throw mismatch();
+      }
+    }
+    // ÿͰĹ淶λ prefix ǡ 2^(g-d)  2^d Ĳλã
+    // ȱ֤ÿͰõҲͰͬһλҲ֤ͬһͰĲλȿһ£
+    //  ReplaceDirectory 淶λͳƵͰ
+    for (size_t b = 0; b < bucket_headers.size(); b++) {
+      size_t stride = 1UL << bucket_headers[b].depth_;
+      for (size_t i = bucket_headers[b].prefix_; i < dir_size; i += stride) {
+        if (ordinals[i] != b) {
+          throw mismatch();
+        }
+      }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(latch_);
+    std::vector<uint32_t> buckets;
+    buckets.reserve(header.num_buckets_);
+    Directory *dir;
+    try {
+      for (size_t b = 0; b < header.num_buckets_; b++) {
+        // Ͱ SetMaxBucketCapacityܶ bucket_size_ Ԫأ
+        size_t capacity = bucket_size_;
+        while (capacity < bucket_headers[b].count_) {
+          capacity = std::min(capacity * 2, max_bucket_capacity_);
+        }
+        buckets.push_back(pool_.Allocate(bucket_headers[b].depth_, bucket_headers[b].prefix_, capacity));
+        pool_.Get(buckets[b])->ReadImage(data + bucket_offsets[b], bucket_headers[b].count_);
+      }
+      dir = new Directory(header.global_depth_, memory_policy_);
+    } catch (...) {
+      // ڴ治ʱ黹ѷͰԭ
+      for (uint32_t bucket : buckets) {
+        pool_.Free(bucket);
+      }
+      throw;
+    }
+    for (size_t i = 0; i < dir_size; i++) {
+      dir->slots_[i].store(buckets[ordinals[i]], std::memory_order_relaxed);
+    }
+    ReplaceDirectory(dir);
+  }
+}
+
+/**
+ * @brief Ʊȫֵ
+ * 
+ * Ŀ¼ɾҪĿ¼˸ڼᱻ޸ġ
+ * 
+ * @return std::vector<std::pair<K, V>> Ͱȫֵ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Snapshot() const -> std::vector<std::pair<K, V>> {
+  std::unique_lock<std::shared_mutex> lock(latch_);
+  std::vector<std::pair<K, V>> items;
+  VisitBuckets(
+      [&items](const Bucket &bucket) {
+        for (size_t i = 0; i < bucket.GetSize(); i++) {
+          items.emplace_back(bucket.GetKey(i), bucket.GetValue(i));
+        }
+      },
+      1);
+  return items;
+}
+
+/**
+ * @brief ÿͰǡһ
+ * 
+ * ֲΪ d Ͱ 2^(g-d) Ŀ¼λ±Ͱǰ׺ĲλĹ淶λ
+ *  SaveImage ֻͬڹ淶λͰ˰Ŀ¼г䣬ʵͰظ
+ * ̲߳Ŀ¼߳еĿ¼֤ڼûзϲ
+ * 
+ * @param visit ÿͰõĺ
+ * @param num_threads ̣߳߳0 ʾÿӲ߳һ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::VisitBuckets(const std::function<void(const Bucket &)> &visit,
+                                                   size_t num_threads) const {
+  const Directory *dir = dir_.load(std::memory_order_acquire);
+  size_t num_slots = dir->slots_.size();
+  auto visit_range = [this, dir, &visit](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      const Bucket *bucket = pool_.Get(dir->Lookup(i));
+      if ((i & ((1UL << bucket->GetDepth()) - 1)) == i) {
+        visit(*bucket);
+      }
+    }
+  };
+
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  num_threads = std::max<size_t>(1, std::min(num_threads, num_slots / MIN_SLOTS_PER_THREAD));
+  if (num_threads == 1) {
+    visit_range(0, num_slots);
+    return;
+  }
+
+  size_t chunk = (num_slots + num_threads - 1) / num_threads;
+  std::vector<std::exception_ptr> errors(num_threads);
+  auto run = [&](size_t t) {
+    try {
+      visit_range(t * chunk, std::min(num_slots, (t + 1) * chunk));
+    } catch (...) {
+      errors[t] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads - 1);
+  for (size_t t = 1; t < num_threads; t++) {
+    workers.emplace_back(run, t);
+  }
+  run(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  for (auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
   }
 }
 
 /**
  * @brief չĿ¼С
  * 
- * Ŀ¼СӱĿ¼ָ븴ƵĿ¼С
+ * Ŀ¼СӱĿ¼ĲλȫΪգʱղλȼھĿ¼жӦĲλ
+ * չκָ룬ƹ֮ÿβͨ MigrateStep ̯ɡ
+ * һչδǨʱȰ֤꣬ prev_ ûпղλ
  */
-template <typename K, typename V>
-void ExtendibleHashTable<K, V>::DirectoryExtension() {
-  size_t old_size = dir_.size();
-  dir_.resize(2 * old_size);
-  std::copy(dir_.begin(), dir_.begin() + old_size, dir_.begin() + old_size);
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::DirectoryExtension() {
+  stats_.doublings_.Add();
+  EndMigration(true);
+  Directory *old_dir = dir_.load(std::memory_order_relaxed);
+  dir_.store(new Directory(old_dir->global_depth_ + 1, memory_policy_, old_dir), std::memory_order_release);
+  buckets_at_depth_.push_back(0);
+  migrating_from_ = old_dir;
+  migrate_cursor_.store(0, std::memory_order_relaxed);
+  migrated_.store(0, std::memory_order_relaxed);
 }
 
 /**
- * @brief ͰԭͰ·䵽Ͱ
+ * @brief ѾĿ¼һβλƵĿ¼
  * 
- * @param key ȷҪѵͰ
+ * ֻ蹲Ŀ¼йʱûзѻϲ޸Ŀ¼Ŀ¼Ҳٱ仯
+ * ߳ͨ migrate_cursor_ 컥صĲλΣѱѻϲдĲλֲ䡣
  */
-template <typename K, typename V>
-void ExtendibleHashTable<K, V>::SplitTheBucket(const K &key) {
-  size_t index = IndexOf(key);
-  auto bucket = dir_[index];
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::MigrateStep() {
+  if (migrating_from_ == nullptr) {
+    return;
+  }
+  size_t old_size = migrating_from_->slots_.size();
+  size_t begin = migrate_cursor_.fetch_add(MIGRATE_CHUNK, std::memory_order_relaxed);
+  if (begin >= old_size) {
+    return;
+  }
+  size_t end = std::min(begin + MIGRATE_CHUNK, old_size);
+  for (size_t i = begin; i < end; i++) {
+    MigrateSlot(i);
+  }
+  migrated_.fetch_add(end - begin, std::memory_order_relaxed);
+}
+
+/**
+ * @brief ƾĿ¼һλĿ¼жӦλ
+ * 
+ * @param index Ŀ¼еĲλ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::MigrateSlot(size_t index) {
+  Directory *dir = dir_.load(std::memory_order_relaxed);
+  uint32_t bucket = migrating_from_->slots_[index].load(std::memory_order_relaxed);
+  for (size_t i : {index, index + migrating_from_->slots_.size()}) {
+    if (dir->slots_[i].load(std::memory_order_relaxed) == 0) {
+      dir->slots_[i].store(bucket, std::memory_order_release);
+    }
+  }
+}
+
+/**
+ * @brief Ŀ¼Ǩ
+ * 
+ * @param finish Ϊ true ʱȸʣĲλֻвλѸʱ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::EndMigration(bool finish) {
+  if (migrating_from_ == nullptr) {
+    return;
+  }
+  size_t old_size = migrating_from_->slots_.size();
+  if (migrated_.load(std::memory_order_relaxed) < old_size) {
+    if (!finish) {
+      return;
+    }
+    for (size_t i = 0; i < old_size; i++) {
+      MigrateSlot(i);
+    }
+  }
+  RetireDirectory(migrating_from_);
+  migrating_from_ = nullptr;
+}
+
+/**
+ * @brief Ŀ¼С
+ * 
+ * ûͰõȫȵλʱĿ¼ȫֻͬ°벿֡
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::DirectoryShrink() {
+  EndMigration(true);
+  Directory *old_dir = dir_.load(std::memory_order_relaxed);
+  auto *new_dir = new Directory(old_dir->global_depth_ - 1, memory_policy_);
+  for (size_t i = 0; i < new_dir->slots_.size(); i++) {
+    new_dir->slots_[i].store(old_dir->Lookup(i), std::memory_order_relaxed);
+  }
+  dir_.store(new_dir, std::memory_order_release);
+  buckets_at_depth_.pop_back();
+  global_depth_--;
+  RetireDirectory(old_dir);
+}
+
+/**
+ * @brief ԭطͰ
+ * 
+ * ԭͰλΪ 0 һ룬ֻзλΪ 1 ԪرƶһͰУظ顣
+ * ÿԪصĹϣֵͰУʱٴμϣ
+ * ˳ҪͰ޸Ŀ¼λŴԭͰɾߵԪأ
+ * ֹ۶κʱҪôľͰҪôͨǰ׺У鷢ּѲԡ
+ * 
+ * @param dir_index ָҪѵͰĿ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::SplitTheBucket(size_t dir_index) {
+  stats_.splits_.Add();
+  Bucket *bucket = BucketAt(dir_index);
   int local_depth = bucket->GetDepth();
-  bucket->IncrementDepth();
+  size_t split_bit = 1UL << local_depth;
+  uint32_t image_index = pool_.Allocate(local_depth + 1, bucket->GetPrefix() | split_bit, bucket->GetCapacity());
+  bucket->MoveSplitImage(pool_.Get(image_index));
+
+  // ָԭͰ 2^(global-local) λǰ׺ĵ local λͬзλΪ 1 һָͰ
+  Directory *dir = dir_.load(std::memory_order_relaxed);
+  for (size_t i = bucket->GetPrefix() | split_bit; i < dir->slots_.size(); i += split_bit << 1) {
+    dir->slots_[i].store(image_index, std::memory_order_release);
+  }
+  bucket->CompleteSplit();
+
+  ++num_buckets_;
+  buckets_at_depth_[local_depth]--;
+  buckets_at_depth_[local_depth + 1] += 2;
+}
+
+/**
+ * @brief жϴȫȵͰǷӦչĿ¼
+ * 
+ * չÿͰƽֵĿ¼λ MAX_SLOTS_PER_BUCKET ʱ˵Ŀ¼ǱȵͰŴģ
+ * ʱֻҪͰûȵĹϣչʱÿͰƽֵֻ 2  4 λӰ졣
+ * 
+ * @param bucket Ҫ뵫Ͱ
+ * @return true ӦͰ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::ShouldGrow(const Bucket *bucket) const -> bool {
+  return bucket->GetCapacity() < max_bucket_capacity_ &&
+         (1UL << (global_depth_ + 1)) > MAX_SLOTS_PER_BUCKET * static_cast<size_t>(num_buckets_);
+}
 
-  auto new_bucket_0 = std::make_shared<Bucket>(bucket_size_, bucket->GetDepth());
-  auto new_bucket_1 = std::make_shared<Bucket>(bucket_size_, bucket->GetDepth());
+/**
+ * @brief һӱͰ滻Ͱ
+ * 
+ * ϲͬ˳ȰԪͰָٰͰĿ¼λΪָͰ
+ * ŰѾͰΪʧЧֹ۶ڴ֮ǰܴӾͰжȷݡ
+ * 
+ * @param dir_index ָҪͰĿ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::GrowBucket(size_t dir_index) {
+  stats_.growths_.Add();
+  uint32_t bucket_index = SlotAt(dir_index);
+  Bucket *bucket = pool_.Get(bucket_index);
+  size_t capacity = std::min(bucket->GetCapacity() * 2, max_bucket_capacity_);
+  uint32_t grown_index = pool_.Allocate(bucket->GetDepth(), bucket->GetPrefix(), capacity);
+  pool_.Get(grown_index)->MoveItemsFrom(bucket);
 
-  size_t depth_mask = (1 << bucket->GetDepth()) - 1;
-  size_t split_bit = 1 << local_depth;
+  Directory *dir = dir_.load(std::memory_order_relaxed);
+  size_t stride = 1UL << bucket->GetDepth();
+  for (size_t i = bucket->GetPrefix(); i < dir->slots_.size(); i += stride) {
+    dir->slots_[i].store(grown_index, std::memory_order_release);
+  }
+  bucket->Retire();
+  RetireBucket(bucket_index);
+}
 
-  for (size_t i = 0; i < dir_.size(); i++) {
-    if (dir_[i] == bucket) {
-      dir_[i] = (i & split_bit) ? new_bucket_1 : new_bucket_0;
+/**
+ * @brief жͰķѾܷϲ
+ * 
+ * ѾǾֲλͬǸͰ߾ֲͬԪͰСһʱźϲ
+ * ϲͰٻҪٲһԪزŻٴηѣڱ߽總ϲ
+ * 
+ * @param dir_index ָͰĿ¼
+ * @return true Ӧϲ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::ShouldMerge(size_t dir_index) const -> bool {
+  Bucket *bucket = BucketAt(dir_index);
+  int depth = bucket->GetDepth();
+  if (depth == 0) {
+    return false;
+  }
+  Bucket *image = BucketAt(dir_index ^ (1UL << (depth - 1)));
+  return image->GetDepth() == depth && bucket->GetSize() + image->GetSize() <= bucket_size_ / 2;
+}
+
+/**
+ * @brief ϲͰĿ¼
+ * 
+ * ѷѾԪ뵱ǰͰָٰĿ¼λΪָǰͰ
+ * ڲλ޸֮űΪʧЧڴ֮ǰֹ۶ܴӾжȷݡ
+ * 
+ * @param dir_index ָҪϲͰĿ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::MergeBuckets(size_t dir_index) {
+  Directory *dir = dir_.load(std::memory_order_relaxed);
+  while (ShouldMerge(dir_index)) {
+    uint32_t bucket_index = SlotAt(dir_index);
+    Bucket *bucket = pool_.Get(bucket_index);
+    int depth = bucket->GetDepth();
+    size_t image_index = dir_index ^ (1UL << (depth - 1));
+    uint32_t image_bucket_index = SlotAt(image_index);
+    Bucket *image = pool_.Get(image_bucket_index);
+
+    bucket->Absorb(image);
+    // ָĲλ image_index ĵ depth λͬ
+    size_t stride = 1UL << depth;
+    for (size_t i = image_index & (stride - 1); i < dir->slots_.size(); i += stride) {
+      dir->slots_[i].store(bucket_index, std::memory_order_release);
     }
+
+    --num_buckets_;
+    buckets_at_depth_[depth] -= 2;
+    buckets_at_depth_[depth - 1]++;
+    image->Retire();
+    RetireBucket(image_bucket_index);
   }
 
-  ++num_buckets_;
-  for (const auto &item : bucket->GetItems()) {
-    size_t new_index = std::hash<K>()(item.first) & depth_mask;
-    if (new_index & split_bit) {
-      new_bucket_1->Insert(item.first, item.second);
-    } else {
-      new_bucket_0->Insert(item.first, item.second);
+  while (global_depth_ > 0 && buckets_at_depth_[global_depth_] == 0) {
+    DirectoryShrink();
+  }
+}
+
+/**
+ * @brief ժͰ
+ * 
+ * ֹ֧۶ҪȵԪȫͷţ͵Ķ߶Ŀ¼ͷš
+ * 
+ * @param bucket ѴĿ¼ժͰ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::RetireBucket(uint32_t bucket) {
+  if constexpr (!OPTIMISTIC_FIND) {
+    pool_.Free(bucket);
+  } else {
+    retired_buckets_.emplace_back(EpochManager::Instance().RetireEpoch(), bucket);
+    ReclaimRetired();
+  }
+}
+
+/**
+ * @brief ѱ滻Ŀ¼
+ * 
+ * @param dir ѱ滻Ŀ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::RetireDirectory(Directory *dir) {
+  if constexpr (!OPTIMISTIC_FIND) {
+    delete dir;
+  } else {
+    retired_directories_.emplace_back(EpochManager::Instance().RetireEpoch(), std::unique_ptr<Directory>(dir));
+    ReclaimRetired();
+  }
+}
+
+/**
+ * @brief ͷж߶ѿͰĿ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::ReclaimRetired() {
+  uint64_t oldest = EpochManager::Instance().OldestActiveEpoch();
+  auto reclaimable = [oldest](const auto &retired) { return retired.first < oldest; };
+  auto freed = std::partition(retired_buckets_.begin(), retired_buckets_.end(),
+                              [&reclaimable](const auto &retired) { return !reclaimable(retired); });
+  for (auto it = freed; it != retired_buckets_.end(); ++it) {
+    pool_.Free(it->second);
+  }
+  retired_buckets_.erase(freed, retired_buckets_.end());
+  retired_directories_.erase(
+      std::remove_if(retired_directories_.begin(), retired_directories_.end(), reclaimable),
+      retired_directories_.end());
+}
+
+/**
+ * @brief ½Ŀ¼滻
+ * 
+ * Ŀ¼ָͰ·ġĿ¼ѾĿ¼ÿͰΪʧЧ
+ * ھͰֹ۶Ķ߻ԲĿ¼Ͱ;Ŀ¼ڼԪȫա
+ * 
+ * @param dir Ŀ¼
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::ReplaceDirectory(Directory *dir) {
+  EndMigration(true);
+  Directory *old_dir = dir_.load(std::memory_order_relaxed);
+  std::vector<uint32_t> old_buckets;
+  for (size_t i = 0; i < old_dir->slots_.size(); i++) {
+    uint32_t bucket = old_dir->Lookup(i);
+    if (i < (1UL << pool_.Get(bucket)->GetDepth())) {
+      old_buckets.push_back(bucket);
+    }
+  }
+
+  dir_.store(dir, std::memory_order_release);
+  global_depth_ = dir->global_depth_;
+  num_buckets_ = 0;
+  buckets_at_depth_.assign(global_depth_ + 1, 0);
+  for (size_t i = 0; i < dir->slots_.size(); i++) {
+    int depth = pool_.Get(dir->Lookup(i))->GetDepth();
+    if (i < (1UL << depth)) {
+      num_buckets_++;
+      buckets_at_depth_[depth]++;
     }
   }
+
+  for (uint32_t bucket : old_buckets) {
+    pool_.Get(bucket)->Retire();
+    RetireBucket(bucket);
+  }
+  RetireDirectory(old_dir);
+}
+
+// ========================== BucketPool ʵ ==========================
+
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::BucketPool::BucketPool(size_t bucket_size, const MemoryPolicy &memory_policy)
+    : bucket_size_(bucket_size),
+      storage_stride_((Bucket::StorageSize(bucket_size) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE),
+      memory_policy_(memory_policy) {}
+
+/**
+ * @brief  BucketPoolδͷŵͰͷ slab
+ */
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::BucketPool::~BucketPool() {
+  std::vector<bool> freed(next_, false);
+  for (uint32_t index : free_) {
+    freed[index] = true;
+  }
+  for (uint32_t index = 1; index < next_; index++) {
+    if (!freed[index]) {
+      Destroy(index);
+    }
+  }
+  for (int slab = 0; slab < NUM_SLABS; slab++) {
+    FreeMemory(slabs_[slab].load(std::memory_order_relaxed), SlabBytes(slab), memory_policy_);
+  }
+}
+
+/**
+ * @brief һͰ
+ * 
+ * ȸͷŵʹһڵ slab ʱȰڴԷ slab
+ * ͰĴ洢λ slab βͰһһӦʱҲĴ洢
+ * slab ͰɺŻᱻдĿ¼˲ Get ܿͰ
+ * 
+ * @param depth Ͱľֲ
+ * @param prefix Ͱǰ׺
+ * @param capacity Ͱ bucket_size_ ʱ洢
+ * @return uint32_t Ͱ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::BucketPool::Allocate(int depth, size_t prefix, size_t capacity) -> uint32_t {
+  uint32_t index;
+  if (!free_.empty()) {
+    index = free_.back();
+    free_.pop_back();
+  } else {
+    BUSTUB_ASSERT(next_ != 0, "bucket pool exhausted");
+    index = next_++;
+    int slab = 31 - __builtin_clz(index);
+    if (slabs_[slab].load(std::memory_order_relaxed) == nullptr) {
+      slabs_[slab].store(static_cast<Bucket *>(AllocateMemory(SlabBytes(slab), memory_policy_)),
+                         std::memory_order_release);
+    }
+  }
+  void *storage;
+  if (capacity == bucket_size_) {
+    int slab = 31 - __builtin_clz(index);
+    storage = reinterpret_cast<char *>(slabs_[slab].load(std::memory_order_relaxed)) + BucketsBytes(slab) +
+              (index - (1U << slab)) * storage_stride_;
+  } else {
+    storage = AllocateMemory(Bucket::StorageSize(capacity), memory_policy_);
+  }
+  new (Get(index)) Bucket(capacity, storage, depth, prefix);
+  return index;
+}
+
+/**
+ * @brief ͷһͰ
+ * 
+ * @param index ҪͷŵͰ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::BucketPool::Free(uint32_t index) {
+  Destroy(index);
+  free_.push_back(index);
+}
+
+/**
+ * @brief һͰͰĴ洢 slab Уһͷ
+ * 
+ * @param index ҪͰ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::BucketPool::Destroy(uint32_t index) {
+  Bucket *bucket = Get(index);
+  size_t capacity = bucket->GetCapacity();
+  void *storage = bucket->GetStorage();
+  bucket->~Bucket();
+  if (capacity != bucket_size_) {
+    FreeMemory(storage, Bucket::StorageSize(capacity), memory_policy_);
+  }
 }
 
 // ========================== Bucket ʵ ==========================
 
+/**
+ * @brief Ͱĸڴ洢еƫ
+ * 
+ * ˳ñǩ뵽飩ԪأֵԼϣֵ飬ÿ鰴Ͷ롣
+ * 
+ * @param array_size ͰС
+ * @return Layout ƫֽ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::ComputeLayout(size_t array_size) -> Layout {
+  auto align_up = [](size_t offset, size_t alignment) { return (offset + alignment - 1) / alignment * alignment; };
+  Layout layout{};
+  layout.num_tags_ = (array_size + TAG_GROUP_SIZE - 1) / TAG_GROUP_SIZE * TAG_GROUP_SIZE;
+  size_t offset = layout.num_tags_;
+  if constexpr (INTERLEAVED) {
+    layout.items_offset_ = align_up(offset, alignof(Item));
+    offset = layout.items_offset_ + array_size * sizeof(Item);
+  } else {
+    layout.keys_offset_ = align_up(offset, alignof(K));
+    layout.values_offset_ = align_up(layout.keys_offset_ + array_size * sizeof(K), alignof(V));
+    offset = layout.values_offset_ + array_size * sizeof(V);
+  }
+  layout.hashes_offset_ = align_up(offset, alignof(size_t));
+  layout.bytes_ = layout.hashes_offset_ + array_size * sizeof(size_t);
+  return layout;
+}
+
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::StorageSize(size_t array_size) -> size_t {
+  return ComputeLayout(array_size).bytes_;
+}
+
 /**
  * @brief  Bucket 
  * 
+ * ڵṩһ黺жĴ洢а ComputeLayout ø飬Ͱڴ档
+ * 
  * @param array_size ͰС
+ * @param storage StorageSize(array_size) ֽڵĴ洢 BucketPool ӵ
  * @param depth Ͱĳʼֲ
+ * @param prefix ͰмĹϣֵеĵ depth λ
+ */
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::Bucket::Bucket(size_t array_size, void *storage, int depth, size_t prefix)
+    : size_(array_size), depth_(depth), prefix_(prefix) {
+  Layout layout = ComputeLayout(array_size);
+  auto *base = static_cast<char *>(storage);
+  tags_ = reinterpret_cast<uint8_t *>(base);
+  std::uninitialized_value_construct_n(tags_, layout.num_tags_);
+  if constexpr (INTERLEAVED) {
+    items_ = reinterpret_cast<Item *>(base + layout.items_offset_);
+    std::uninitialized_value_construct_n(items_, array_size);
+  } else {
+    keys_ = reinterpret_cast<K *>(base + layout.keys_offset_);
+    values_ = reinterpret_cast<V *>(base + layout.values_offset_);
+    std::uninitialized_value_construct_n(keys_, array_size);
+    std::uninitialized_value_construct_n(values_, array_size);
+  }
+  hashes_ = reinterpret_cast<size_t *>(base + layout.hashes_offset_);
+  std::uninitialized_value_construct_n(hashes_, array_size);
+}
+
+template <typename K, typename V, typename Hash>
+ExtendibleHashTable<K, V, Hash>::Bucket::~Bucket() {
+  if constexpr (!INTERLEAVED) {
+    std::destroy_n(keys_, size_);
+    std::destroy_n(values_, size_);
+  }
+}
+
+/**
+ * @brief ǰ count λвҼ
+ * 
+ * ÿ SIMD Ƚһǩõλ룬ֻԱǩͬĲλȽϼ
+ * ͨͰֻҪָһμıȽϡ
+ * 
+ * @param key Ҫҵļ
+ * @param tag ıǩ
+ * @param count Чλ
+ * @return size_t ڵĲλʱ count
  */
-template <typename K, typename V>
-ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth)
-    : size_(array_size), depth_(depth) {
+template <typename K, typename V, typename Hash>
+template <bool LATCH_FREE>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::FindSlot(const K &key, uint8_t tag, size_t count) const -> size_t {
+  for (size_t group = 0; group < count; group += TAG_GROUP_SIZE) {
+    uint32_t mask;
+    if constexpr (LATCH_FREE) {
+      // Ͱʱд߿޸ıǩԭӶȡƳٱȽ
+      alignas(TAG_GROUP_SIZE) uint8_t tags[TAG_GROUP_SIZE];
+      LoadTagGroup(group, tags);
+      mask = MatchTagGroup(tags, tag);
+    } else {
+      mask = MatchTagGroup(&tags_[group], tag);
+    }
+    if (count - group < TAG_GROUP_SIZE) {
+      mask &= (1U << (count - group)) - 1;  // Чλвıǩ
+    }
+    while (mask != 0) {
+      size_t slot = group + __builtin_ctz(mask);
+      if constexpr (LATCH_FREE) {
+        if (LoadShared(KeyAt(slot)) == key) {
+          return slot;
+        }
+      } else if (KeyAt(slot) == key) {
+        return slot;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return count;
 }
 
 /**
  * @brief Ͱвֵָ
  * 
  * @param key Ҫҵļ
+ * @param hash Ĺϣֵ
  * @param value 洢ҵֵ
  * @return true ҵ true򷵻 false
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
-  auto it = std::find_if(list_.begin(), list_.end(), [&](const auto &item) {
-    return item.first == key;
-  });
-  if (it != list_.end()) {
-    value = it->second;
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::Find(const K &key, size_t hash, V &value) -> bool {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  size_t count = GetSize();
+  size_t slot = FindSlot(key, TagOf(hash), count);
+  if (slot != count) {
+    value = ValueAt(slot);
     return true;
   }
   return false;
 }
 
+/**
+ * @brief Ͱвֵָָָ
+ * 
+ * @param key Ҫҵļ
+ * @param hash Ĺϣֵ
+ * @return V* Ͱбֵδҵʱ nullptr
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::FindPtr(const K &key, size_t hash) -> V * {
+  std::shared_lock<std::shared_mutex> lock(latch_);
+  size_t count = GetSize();
+  size_t slot = FindSlot(key, TagOf(hash), count);
+  return slot != count ? &ValueAt(slot) : nullptr;
+}
+
+/**
+ * @brief Ͱвֵָ
+ * 
+ * ȶȡ汾ţٶȡݣȷϰ汾ûб仯
+ * ǩֵд߲ʣ˫ʹ relaxed ԭӲ StoreShared˲ݾ
+ * 汾Ϊд޸ĻͰѱϲǰһʱݿܲҪԡ
+ * ĹϣֵͰǰ׺ʱ˵ǾڵĿ¼λġߣͬҪԡ
+ * 
+ * @param key Ҫҵļ
+ * @param hash Ĺϣֵ
+ * @param value 洢ҵֵãֻҵУͨʱŻд
+ * @param found Ƿҵ
+ * @return true ȡЧfalse ʾҪ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::OptimisticFind(const K &key, size_t hash, V &value, bool *found) const
+    -> bool {
+  uint64_t version = version_.load(std::memory_order_acquire);
+  if ((version & 1) != 0) {
+    return false;
+  }
+  size_t count = std::min(GetSize(), size_);
+  size_t slot = FindSlot<true>(key, TagOf(hash), count);
+  V result{};
+  if (slot != count) {
+    result = LoadShared(ValueAt(slot));
+  }
+  size_t depth_mask = (1UL << GetDepth()) - 1;
+  size_t prefix = GetPrefix();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (version_.load(std::memory_order_relaxed) != version || (hash & depth_mask) != prefix) {
+    return false;
+  }
+  *found = slot != count;
+  if (*found) {
+    value = result;
+  }
+  return true;
+}
+
 /**
  * @brief ͰƳָļֵ
  * 
+ * һԪɾλãԪš
+ * 
  * @param key ҪƳļ
+ * @param hash Ĺϣֵ
  * @return true Ƴɹ true򷵻 false
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
-  auto it = std::find_if(list_.begin(), list_.end(), [&](const auto &item) {
-    return item.first == key;
-  });
-  if (it != list_.end()) {
-    list_.erase(it);
-    return true;
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::Remove(const K &key, size_t hash) -> bool {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  size_t count = GetSize();
+  size_t slot = FindSlot(key, TagOf(hash), count);
+  if (slot == count) {
+    return false;
   }
-  return false;
+  BeginWrite();
+  size_t last = count - 1;
+  if (slot != last) {
+    StoreShared(tags_[slot], tags_[last]);
+    StoreShared(KeyAt(slot), std::move(KeyAt(last)));
+    StoreShared(ValueAt(slot), std::move(ValueAt(last)));
+    hashes_[slot] = hashes_[last];
+  }
+  count_.store(last, std::memory_order_relaxed);
+  EndWrite();
+  return true;
 }
 
 /**
  * @brief Ͱвֵ
  * 
  * @param key Ҫļ
+ * @param hash Ĺϣֵ
  * @param value Ӧֵ
  * @return true ɹ trueͰ false
  */
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-  auto it = std::find_if(list_.begin(), list_.end(), [&](const auto &item) {
-    return item.first == key;
-  });
-  if (it != list_.end()) {
-    it->second = value;  // мֵ
-    return true;
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::Insert(const K &key, size_t hash, const V &value) -> bool {
+  bool inserted;
+  return Put(key, hash, value, true, &inserted) != nullptr;
+}
+
+/**
+ * @brief Ͱв¼ֵԣת
+ * 
+ * @param key Ҫļ
+ * @param hash Ĺϣֵ
+ * @param value Ӧֵ
+ * @param assign ѴʱǷ񸲸ԭеֵ
+ * @param inserted Ƿµļֵ
+ * @return V* ͰбֵͰʱ nullptrʱᱻƶ
+ */
+template <typename K, typename V, typename Hash>
+template <typename KArg, typename VArg>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::Put(KArg &&key, size_t hash, VArg &&value, bool assign, bool *inserted)
+    -> V * {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  size_t count = GetSize();
+  uint8_t tag = TagOf(hash);
+  size_t slot = FindSlot(key, tag, count);
+  *inserted = false;
+  if (slot != count) {
+    if (assign) {
+      BeginWrite();
+      StoreShared(ValueAt(slot), std::forward<VArg>(value));  // мֵ
+      EndWrite();
+    }
+    return &ValueAt(slot);
   }
   if (IsFull()) {
-    return false;
+    return nullptr;
+  }
+  BeginWrite();
+  StoreShared(tags_[count], tag);
+  StoreShared(KeyAt(count), std::forward<KArg>(key));
+  StoreShared(ValueAt(count), std::forward<VArg>(value));
+  hashes_[count] = hash;
+  count_.store(count + 1, std::memory_order_relaxed);
+  EndWrite();
+  *inserted = true;
+  return &ValueAt(count);
+}
+
+/**
+ * @brief ѷѾеԪȫ뱾Ͱ
+ * 
+ * Ͱļ֤ͬ߱ŵ£ء
+ * 
+ * @param other ҪϲķѾ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::Absorb(Bucket *other) {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  BeginWrite();
+  for (size_t i = 0; i < other->GetSize(); i++) {
+    Append(other->tags_[i], std::move(other->KeyAt(i)), std::move(other->ValueAt(i)), other->hashes_[i]);
+  }
+  DecrementDepth();
+  EndWrite();
+}
+
+/**
+ * @brief ѱ滻ͰеԪȫ뱾Ͱ
+ * 
+ * Ͱʱܱκζ߷ʣ˲Ҫ汾ţͰȺǰ׺ͬء
+ * 
+ * @param other Ͱ滻Ͱ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::MoveItemsFrom(Bucket *other) {
+  std::scoped_lock<std::shared_mutex> lock(other->latch_);
+  for (size_t i = 0; i < other->GetSize(); i++) {
+    Append(other->tags_[i], std::move(other->KeyAt(i)), std::move(other->ValueAt(i)), other->hashes_[i]);
+  }
+}
+
+/**
+ * @brief ԭطѵĵһѷλΪ 1 ԪƶͰ
+ * 
+ * Ͱʱܱκζ߷ʣ˲Ҫ汾š
+ * ֹ۶ָֻͣƶƣͰбߵԪضԶȻ
+ * 
+ * @param image շλΪ 1 ԪصĿͰ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::MoveSplitImage(Bucket *image) {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  size_t split_bit = 1UL << GetDepth();
+  for (size_t i = 0; i < GetSize(); i++) {
+    if ((hashes_[i] & split_bit) != 0) {
+      image->Append(tags_[i], std::move(KeyAt(i)), std::move(ValueAt(i)), hashes_[i]);
+    }
+  }
+}
+
+/**
+ * @brief ԭطѵĵڶɾƶͰԪأӾֲ
+ * 
+ * ʣԪذԭ˳ǰƣš
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::CompleteSplit() {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  size_t split_bit = 1UL << GetDepth();
+  size_t count = GetSize();
+  BeginWrite();
+  size_t kept = 0;
+  for (size_t i = 0; i < count; i++) {
+    if ((hashes_[i] & split_bit) == 0) {
+      if (kept != i) {
+        StoreShared(tags_[kept], tags_[i]);
+        StoreShared(KeyAt(kept), std::move(KeyAt(i)));
+        StoreShared(ValueAt(kept), std::move(ValueAt(i)));
+        hashes_[kept] = hashes_[i];
+      }
+      kept++;
+    }
+  }
+  count_.store(kept, std::memory_order_relaxed);
+  IncrementDepth();
+  EndWrite();
+}
+
+/**
+ * @brief ĩβ׷һԪأظ
+ * 
+ * @param tag ıǩ
+ * @param key 
+ * @param value ֵ
+ * @param hash Ĺϣֵ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::Append(uint8_t tag, K &&key, V &&value, size_t hash) {
+  size_t count = GetSize();
+  StoreShared(tags_[count], tag);
+  StoreShared(KeyAt(count), std::move(key));
+  StoreShared(ValueAt(count), std::move(value));
+  hashes_[count] = hash;
+  count_.store(count + 1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Ͱԭʼ׷ӵ
+ * 
+ * @param out ļ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::WriteImage(std::ostream &out) const {
+  if constexpr (IMAGE_SUPPORTED) {
+    size_t count = GetSize();
+    ImageBucketHeader header{static_cast<uint32_t>(GetDepth()), static_cast<uint32_t>(count), GetPrefix()};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(tags_), count * sizeof(uint8_t));
+    if constexpr (INTERLEAVED) {
+      // мֵʼ飬ڴ沼޹
+      for (size_t i = 0; i < count; i++) {
+        out.write(reinterpret_cast<const char *>(&items_[i].key_), sizeof(K));
+      }
+      for (size_t i = 0; i < count; i++) {
+        out.write(reinterpret_cast<const char *>(&items_[i].value_), sizeof(V));
+      }
+    } else {
+      out.write(reinterpret_cast<const char *>(keys_), count * sizeof(K));
+      out.write(reinterpret_cast<const char *>(values_), count * sizeof(V));
+    }
+    out.write(reinterpret_cast<const char *>(hashes_), count * sizeof(size_t));
+  }
+}
+
+/**
+ * @brief Ӿи count ԪصͰ
+ * 
+ * @param data Ͱԭʼھеʼλ
+ * @param count Ԫ
+ * @return size_t ȡֽ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::ReadImage(const char *data, size_t count) -> size_t {
+  const char *begin = data;
+  if constexpr (IMAGE_SUPPORTED) {
+    std::scoped_lock<std::shared_mutex> lock(latch_);
+    BeginWrite();
+    memcpy(tags_, data, count * sizeof(uint8_t));
+    data += count * sizeof(uint8_t);
+    if constexpr (INTERLEAVED) {
+      for (size_t i = 0; i < count; i++) {
+        memcpy(&items_[i].key_, data + i * sizeof(K), sizeof(K));
+        memcpy(&items_[i].value_, data + count * sizeof(K) + i * sizeof(V), sizeof(V));
+      }
+    } else {
+      memcpy(keys_, data, count * sizeof(K));
+      memcpy(values_, data + count * sizeof(K), count * sizeof(V));
+    }
+    data += count * (sizeof(K) + sizeof(V));
+    memcpy(hashes_, data, count * sizeof(size_t));
+    data += count * sizeof(size_t);
+    count_.store(count, std::memory_order_relaxed);
+    EndWrite();
+  }
+  return data - begin;
+}
+
+/**
+ * @brief У龵һͰԭʼ
+ * 
+ * ϣֵĵ depth λǰ׺ͬļԶ鲻ʱҲᱻֵһ룻
+ * ǩϣֵļԶᱻƥ䡣
+ * 
+ * @param data Ͱԭʼھеʼλ
+ * @param count Ԫ
+ * @param depth Ͱľֲ
+ * @param prefix Ͱǰ׺
+ * @return true ԪضͰ
+ */
+template <typename K, typename V, typename Hash>
+auto ExtendibleHashTable<K, V, Hash>::Bucket::CheckImage(const char *data, size_t count, int depth, size_t prefix)
+    -> bool {
+  const char *hashes = data + count * (sizeof(uint8_t) + sizeof(K) + sizeof(V));
+  size_t depth_mask = (1UL << depth) - 1;
+  for (size_t i = 0; i < count; i++) {
+    size_t hash;
+    memcpy(&hash, hashes + i * sizeof(size_t), sizeof(size_t));
+    if ((hash & depth_mask) != prefix || static_cast<uint8_t>(data[i]) != TagOf(hash)) {
+      return false;
+    }
   }
-  list_.emplace_back(key, value);
   return true;
 }
 
+/**
+ * @brief ͰΪѱϲ滻
+ * 
+ * ֻʼд汾ԶΪ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::Retire() {
+  std::scoped_lock<std::shared_mutex> lock(latch_);
+  BeginWrite();
+}
+
+/**
+ * @brief ʼ޸Ͱ汾űΪ
+ * 
+ * ֻгͰд߻޸İ汾ţԭӵĶ--д
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::BeginWrite() {
+  version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief ޸Ͱ汾űż֮ǰ޸Ķֹ۶ɼ
+ */
+template <typename K, typename V, typename Hash>
+void ExtendibleHashTable<K, V, Hash>::Bucket::EndWrite() {
+  version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
 // ========================== ģʽʵ ==========================
 
 template class ExtendibleHashTable<page_id_t, Page *>;
@@ -253,6 +1817,8 @@ template class ExtendibleHashTable<Page *, std::list<Page *>::iterator>;
 template class ExtendibleHashTable<int, int>;
 template class ExtendibleHashTable<int, std::string>;
 template class ExtendibleHashTable<int, std::list<int>::iterator>;
+template class ExtendibleHashTable<page_id_t, Page *, IntegerMixHash<page_id_t>>;
+template class ExtendibleHashTable<int, int, IntegerMixHash<int>>;
 
 }  // namespace bustub
 
@@ -17,22 +17,104 @@
 
 #pragma once
 
-#include <list>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <new>
 #include <mutex>  // NOLINT
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#if !defined(BUSTUB_DISABLE_SIMD) && (defined(__AVX2__) || defined(__SSE2__))
+#include <immintrin.h>
+#elif !defined(BUSTUB_DISABLE_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "common/epoch_manager.h"
+#include "common/macros.h"
+#include "common/memory_policy.h"
+#include "common/stats.h"
 #include "container/hash/hash_table.h"
 
 namespace bustub {
 
+/**
+ * Number of tags compared at once by a bucket probe: one AVX2 register, one SSE2/NEON register,
+ * or 8 bytes for the scalar fallback. Define BUSTUB_DISABLE_SIMD to force the scalar fallback.
+ */
+#if !defined(BUSTUB_DISABLE_SIMD) && defined(__AVX2__)
+static constexpr size_t TAG_GROUP_SIZE = 32;
+#elif !defined(BUSTUB_DISABLE_SIMD) && (defined(__SSE2__) || (defined(__ARM_NEON) && defined(__aarch64__)))
+static constexpr size_t TAG_GROUP_SIZE = 16;
+#else
+static constexpr size_t TAG_GROUP_SIZE = 8;
+#endif
+
+/**
+ * @brief Compare a group of TAG_GROUP_SIZE tags against one tag.
+ * @param group The first tag of the group; TAG_GROUP_SIZE bytes must be readable.
+ * @param tag The tag to look for.
+ * @return A bitmask with bit i set iff group[i] == tag.
+ */
+inline auto MatchTagGroup(const uint8_t *group, uint8_t tag) -> uint32_t {
+#if !defined(BUSTUB_DISABLE_SIMD) && defined(__AVX2__)
+  __m256i tags = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(group));
+  __m256i eq = _mm256_cmpeq_epi8(tags, _mm256_set1_epi8(static_cast<char>(tag)));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+#elif !defined(BUSTUB_DISABLE_SIMD) && defined(__SSE2__)
+  __m128i tags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+  __m128i eq = _mm_cmpeq_epi8(tags, _mm_set1_epi8(static_cast<char>(tag)));
+  return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+#elif !defined(BUSTUB_DISABLE_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+  // NEON has no movemask: keep one distinct bit per byte lane, then add up each half.
+  static const uint8_t lane_bits_data[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  uint8x16_t eq = vceqq_u8(vld1q_u8(group), vdupq_n_u8(tag));
+  uint8x16_t bits = vandq_u8(eq, vld1q_u8(lane_bits_data));
+  return static_cast<uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+         (static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < TAG_GROUP_SIZE; i++) {
+    mask |= static_cast<uint32_t>(group[i] == tag) << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * Hasher for integral keys that mixes every bit of the key into every bit of the hash (the
+ * splitmix64 finalizer). std::hash is the identity for integers, so keys that share a stride,
+ * e.g. page ids allocated in extents, all land in the same few buckets and drive the global depth
+ * up. Use it as the Hash parameter of ExtendibleHashTable.
+ */
+template <typename K>
+struct IntegerMixHash {
+  auto operator()(K key) const -> size_t {
+    auto x = static_cast<uint64_t>(key);
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return static_cast<size_t>(x);
+  }
+};
+
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
  * @tparam K key type
  * @tparam V value type
+ * @tparam Hash hasher for K; the low bits of the hash pick the directory slot
  */
-template <typename K, typename V>
+template <typename K, typename V, typename Hash = std::hash<K>>
 class ExtendibleHashTable : public HashTable<K, V> {
  public:
   /**
@@ -41,8 +123,13 @@ class ExtendibleHashTable : public HashTable<K, V> {
    *
    * @brief Create a new ExtendibleHashTable.
    * @param bucket_size: fixed size for each bucket
+   * @param hash_fn: the hasher for keys
+   * @param memory_policy: how the directory and the bucket slabs are backed, e.g. with huge pages
    */
-  explicit ExtendibleHashTable(size_t bucket_size);
+  explicit ExtendibleHashTable(size_t bucket_size, const Hash &hash_fn = Hash(),
+                               const MemoryPolicy &memory_policy = MemoryPolicy());
+
+  ~ExtendibleHashTable() override;
 
   /**
    * @brief Get the global depth of the directory.
@@ -63,6 +150,27 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   auto GetNumBuckets() const -> int;
 
+  /** A snapshot of the table's counters; see GetStats. */
+  struct Stats {
+    uint64_t finds;                // Keys looked up by Find, FindPtr and FindBatch
+    uint64_t hits;                 // Lookups that found their key
+    uint64_t misses;               // finds - hits
+    uint64_t inserts;              // Insert, Emplace and InsertOrAssign calls
+    uint64_t splits;               // Bucket splits
+    uint64_t directory_doublings;  // Directory doublings
+    uint64_t bucket_growths;       // Buckets grown instead of doubling the directory (see SetMaxBucketCapacity)
+    double avg_bucket_occupancy;   // Pairs over the total bucket capacity, at the time of the call
+    uint64_t latch_contended;      // Directory latch acquisitions that had to wait
+    uint64_t latch_wait_ns;        // Total time spent waiting for the directory latch
+  };
+
+  /**
+   * @brief Aggregate the per-thread counters. The hot-path counters are only maintained when
+   * BUSTUB_ENABLE_STATS is defined and read as 0 otherwise; avg_bucket_occupancy is always
+   * computed, by walking the buckets under the shared directory latch.
+   */
+  auto GetStats() const -> Stats;
+
   /**
    *
    * TODO(P1): Add implementation
@@ -71,6 +179,10 @@ class ExtendibleHashTable : public HashTable<K, V> {
    *
    * Use IndexOf(key) to find the directory index the key hashes to.
    *
+   * When both K and V are integral or pointer types (e.g. the page table), Find takes no latch at
+   * all: it reads the directory and the bucket optimistically and validates the bucket's version
+   * afterwards, retrying if a writer got in the way. Other types use the latched path.
+   *
    * @param key The key to be searched.
    * @param[out] value The value associated with the key.
    * @return True if the key is found, false otherwise.
@@ -94,34 +206,293 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   void Insert(const K &key, const V &value) override;
 
+  /**
+   * @brief Insert the given key-value pair, moving both into the table instead of copying them.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(K &&key, V &&value);
+
+  /**
+   * @brief Insert a value constructed from args if the key is not in the table yet; an existing
+   * value is left untouched. The value is constructed once and moved into its bucket.
+   * @param key The key to be inserted.
+   * @param args The arguments to construct the value from.
+   * @return True if the pair was inserted, false if the key already existed.
+   */
+  template <typename... Args>
+  auto Emplace(const K &key, Args &&...args) -> bool {
+    return EmplaceValue(key, V(std::forward<Args>(args)...));
+  }
+
+  /**
+   * @brief Insert the given key-value pair, or overwrite the value if the key exists.
+   *
+   * The returned reference, like the pointer returned by FindPtr, points into the bucket: it stays
+   * valid only until the next Insert or Remove on the table, and must not be used while other
+   * threads may modify the table.
+   *
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   * @return The value stored in the table.
+   */
+  auto InsertOrAssign(const K &key, V value) -> V &;
+
+  /**
+   * @brief Find the value associated with the given key without copying it.
+   * @param key The key to be searched.
+   * @return The value stored in the table (valid as for InsertOrAssign), or nullptr if not found.
+   */
+  auto FindPtr(const K &key) -> V *;
+
   /**
    *
    * TODO(P1): Add implementation
    *
    * @brief Given the key, remove the corresponding key-value pair in the hash table.
-   * Shrink & Combination is not required for this project
+   *
+   * If the bucket and its split image (the bucket that differs only in the top bit of the local
+   * depth) then hold at most bucket_size / 2 items together, they are merged back into one bucket,
+   * repeatedly, and the directory is halved while no bucket uses its top bit. Merging only down
+   * to half a bucket, rather than to a full one, is the hysteresis that keeps an insert/remove mix
+   * around the boundary from splitting and merging the same bucket over and over.
+   *
    * @param key The key to be deleted.
    * @return True if the key exists, false otherwise.
    */
   auto Remove(const K &key) -> bool override;
 
+  /**
+   * @brief Find the values associated with a batch of keys.
+   *
+   * Equivalent to calling Find on every key, but the keys are processed in groups of
+   * BATCH_GROUP_SIZE: all keys of a group are hashed and their directory slots prefetched, then
+   * their buckets prefetched, and only then probed, so the cache misses of a group overlap instead
+   * of being paid one after another. The directory latch (for types without optimistic Find) is
+   * taken once for the whole batch.
+   *
+   * @param keys The keys to be searched.
+   * @param count The number of keys.
+   * @param[out] values Array of count values; values[i] is written if keys[i] is found.
+   * @param[out] found Resized to count; found[i] is set iff keys[i] is found.
+   * @return The number of keys found.
+   */
+  auto FindBatch(const K *keys, size_t count, V *values, std::vector<bool> *found) -> size_t;
+
+  /**
+   * @brief Insert a batch of key-value pairs, in order.
+   *
+   * Equivalent to calling Insert on every pair. Pairs whose bucket has room are inserted under a
+   * single shared acquisition of the directory latch, with the same prefetching as FindBatch; from
+   * the first pair whose bucket is full onward, the remaining pairs go through the regular Insert
+   * path so that later pairs still win over earlier ones with the same key.
+   *
+   * @param keys The keys to be inserted.
+   * @param values The values to be inserted, values[i] for keys[i].
+   * @param count The number of pairs.
+   */
+  void InsertBatch(const K *keys, const V *values, size_t count);
+
+  /**
+   * @brief Load a batch of pairs into an empty table in one pass.
+   *
+   * Instead of growing through every intermediate doubling and split, the final directory is
+   * computed up front: the global depth is the smallest one at which no directory slot receives
+   * more than bucket_size keys, and sibling slots whose keys fit together in one bucket share a
+   * bucket of lower local depth. Each bucket is then allocated once and filled directly. Later
+   * pairs win over earlier ones with the same key. A table that is not empty falls back to
+   * InsertBatch.
+   *
+   * @param keys The keys to be inserted.
+   * @param values The values to be inserted, values[i] for keys[i].
+   * @param count The number of pairs.
+   */
+  void BulkLoad(const K *keys, const V *values, size_t count);
+
+  /**
+   * @brief BulkLoad the pairs of an iterator range, e.g. of a std::vector<std::pair<K, V>> or a
+   * std::map. The keys and values are copied into two arrays first.
+   * @param first The first pair.
+   * @param last One past the last pair.
+   */
+  template <typename InputIt>
+  void BulkLoad(InputIt first, InputIt last) {
+    std::vector<K> keys;
+    std::vector<V> values;
+    for (; first != last; ++first) {
+      keys.push_back(first->first);
+      values.push_back(first->second);
+    }
+    BulkLoad(keys.data(), values.data(), keys.size());
+  }
+
+  /**
+   * @brief Presize the table for n pairs, so that inserting them skips the directory doublings and
+   * most of the splits on the way.
+   *
+   * The global depth is set by the fullest slot rather than the average fill, so the directory is
+   * doubled up front to the depth at which n uniformly hashed pairs are expected to leave no slot
+   * with more than bucket_size pairs. Buckets are only split down to the depth at which they would
+   * be RESERVE_LOAD_PERCENT percent full, the fill inserts settle at; the rest of the splits happen
+   * as buckets actually fill up, and removes may merge reserved buckets that stay nearly empty.
+   * Throws std::runtime_error if the depth would exceed MAX_IMAGE_DEPTH.
+   *
+   * @param n The number of pairs the table should hold.
+   */
+  void Reserve(size_t n);
+
+  /**
+   * @brief Let a hot bucket grow instead of doubling the directory.
+   *
+   * Splitting a full bucket at the global depth doubles the whole directory. With skewed hashes a
+   * few hot buckets keep doing so while most slots point to shallow buckets, and the directory
+   * blows up. Above the bucket size, such a bucket is instead replaced by one of twice its capacity,
+   * up to max_capacity, whenever doubling would leave more than MAX_SLOTS_PER_BUCKET directory slots
+   * per bucket. Otherwise, or once the bucket is at max_capacity, the directory doubles as usual.
+   * Both halves of a grown bucket keep its capacity when it later splits.
+   *
+   * @param max_capacity The largest capacity a bucket may grow to; the bucket size (the default)
+   * disables growing.
+   */
+  void SetMaxBucketCapacity(size_t max_capacity);
+
+  /**
+   * @brief Write the table to a flat binary image: a header, the directory as bucket ordinals, then
+   * the raw tag/key/value/hash arrays of every bucket.
+   *
+   * Only supported when K and V are trivially copyable; throws std::runtime_error otherwise or on
+   * an I/O error. Writers are blocked while the image is written.
+   *
+   * @param path The file to write.
+   */
+  void SaveImage(const std::string &path) const;
+
+  /**
+   * @brief Replace the contents of the table with an image written by SaveImage.
+   *
+   * The file is memory-mapped and every bucket array is copied in with a single memcpy: no key is
+   * hashed, compared or inserted, and the directory is rebuilt at its final size. The image must
+   * come from a table with the same K, V, bucket size and hash function. Throws std::runtime_error
+   * if the file cannot be read or does not match, including a directory whose slots disagree with
+   * the buckets' depths and prefixes, an item whose hash or tag does not belong to its bucket, and a
+   * bucket larger than SetMaxBucketCapacity allows.
+   *
+   * @param path The file to read.
+   */
+  void LoadImage(const std::string &path);
+
+  /**
+   * @brief Call fn(key, value) for every item, visiting each bucket once (directory slots that
+   * alias a bucket are skipped).
+   *
+   * The directory latch is held shared throughout, so no bucket splits or merges during the walk,
+   * and each bucket is read under its own latch, so every bucket is seen in a consistent state.
+   * Inserts and removes in other buckets may run concurrently; use Snapshot for a point-in-time
+   * view of the whole table. fn must not call back into the table.
+   */
+  template <typename Fn>
+  void ForEach(Fn &&fn) const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    VisitBuckets([&fn](const Bucket &bucket) { bucket.ForEachItem(fn); }, 1);
+  }
+
+  /**
+   * @brief ForEach with the directory split into contiguous ranges, one per thread, so a pass over a
+   * large table scales with cores. fn is called concurrently and must be thread-safe; an exception
+   * thrown by fn is rethrown once every thread has finished.
+   * @param num_threads The number of threads including the caller; 0 picks one per hardware thread.
+   */
+  template <typename Fn>
+  void ParallelForEach(Fn &&fn, size_t num_threads = 0) const {
+    std::shared_lock<std::shared_mutex> lock(latch_);
+    VisitBuckets([&fn](const Bucket &bucket) { bucket.ForEachItem(fn); }, num_threads);
+  }
+
+  /**
+   * @brief Copy every item of the table as of a single point in time. Inserts and removes wait
+   * while the items are copied; optimistic Finds do not.
+   * @return The items, grouped by bucket.
+   */
+  auto Snapshot() const -> std::vector<std::pair<K, V>>;
+
   /**
    * Bucket class for each hash table bucket that the directory points to.
+   *
+   * Each bucket has its own latch: Find takes it shared, Insert and Remove take it exclusively.
+   * The directory latch must be held (at least shared) while calling into a bucket, since it is
+   * what keeps the bucket's local depth stable.
+   *
+   * Items live in flat arrays carved out of one cache-line-aligned block of StorageSize(size)
+   * bytes, handed to the bucket at construction by the BucketPool: a one-byte tag (fingerprint of
+   * the hash) per slot, the keys and values, and the full hash of each key. When both K and V are
+   * integral or pointer types (the page table, <int, int>), keys and values are interleaved as
+   * {key, value} items, so a hit reads its value from the line it compared the key on; other types
+   * keep separate key and value arrays. The stored hash lets a split redistribute items without
+   * calling the hasher again. A probe compares the tags a group at a time with SIMD (see
+   * MatchTagGroup), only compares keys whose tag matches, and never touches the values of
+   * non-matching slots. The tag array is padded to a whole number of groups. Every modification is
+   * bracketed by a version counter (a seqlock), so OptimisticFind can read the bucket without
+   * taking the latch.
+   *
+   * Callers pass the key's hash alongside the key so that the tag is not recomputed.
+   *
+   * A bucket of local depth d also records its prefix, the low d bits shared by the hashes of all of
+   * its keys. A split keeps the half whose new bit is 0 in place, so an optimistic reader that
+   * reached the bucket through a stale directory slot notices that its key no longer belongs here.
    */
   class Bucket {
    public:
-    explicit Bucket(size_t size, int depth = 0);
+    /**
+     * @param size The maximum number of items.
+     * @param storage A CACHE_LINE_SIZE-aligned block of StorageSize(size) bytes, owned by the caller.
+     */
+    Bucket(size_t size, void *storage, int depth = 0, size_t prefix = 0);
+
+    /** @brief Get the number of bytes of storage a bucket of the given size lays its arrays out in. */
+    static auto StorageSize(size_t size) -> size_t;
+
+    ~Bucket();
+
+    DISALLOW_COPY_AND_MOVE(Bucket);
 
     /** @brief Check if a bucket is full. */
-    inline auto IsFull() const -> bool { return list_.size() == size_; }
+    inline auto IsFull() const -> bool { return GetSize() == size_; }
 
     /** @brief Get the local depth of the bucket. */
-    inline auto GetDepth() const -> int { return depth_; }
+    inline auto GetDepth() const -> int { return depth_.load(std::memory_order_relaxed); }
+
+    /** @brief Get the low GetDepth() bits shared by the hashes of all keys in the bucket. */
+    inline auto GetPrefix() const -> size_t { return prefix_.load(std::memory_order_relaxed); }
+
+    /** @brief Get the number of items in the bucket. */
+    inline auto GetSize() const -> size_t { return count_.load(std::memory_order_relaxed); }
 
-    /** @brief Increment the local depth of a bucket. */
-    inline void IncrementDepth() { depth_++; }
+    /** @brief Get the key of the i-th item of the bucket, i < GetSize(). */
+    inline auto GetKey(size_t i) const -> const K & { return KeyAt(i); }
 
-    inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
+    /** @brief Get the value of the i-th item of the bucket, i < GetSize(). */
+    inline auto GetValue(size_t i) const -> const V & { return ValueAt(i); }
+
+    /** @brief Get the maximum number of items of the bucket. */
+    inline auto GetCapacity() const -> size_t { return size_; }
+
+    /** @brief Get the storage block passed at construction. */
+    inline auto GetStorage() const -> void * { return tags_; }
+
+    /** @brief Get the hash of the key of the i-th item of the bucket, i < GetSize(). */
+    inline auto GetHash(size_t i) const -> size_t { return hashes_[i]; }
+
+    /** @brief Call fn(key, value) for every item, holding the bucket latch shared. */
+    template <typename Fn>
+    void ForEachItem(Fn &fn) const {
+      std::shared_lock<std::shared_mutex> lock(latch_);
+      for (size_t i = 0; i < GetSize(); i++) {
+        fn(KeyAt(i), ValueAt(i));
+      }
+    }
+
+    /** @brief Prefetch the bucket's tag array, the first thing a probe reads. */
+    inline void PrefetchTags() const { __builtin_prefetch(tags_); }
 
     /**
      *
@@ -129,10 +500,30 @@ class ExtendibleHashTable : public HashTable<K, V> {
      *
      * @brief Find the value associated with the given key in the bucket.
      * @param key The key to be searched.
+     * @param hash The hash of the key.
      * @param[out] value The value associated with the key.
      * @return True if the key is found, false otherwise.
      */
-    auto Find(const K &key, V &value) -> bool;
+    auto Find(const K &key, size_t hash, V &value) -> bool;
+
+    /**
+     * @brief Find the value associated with the given key without taking the bucket latch.
+     * Only valid when OPTIMISTIC_FIND holds.
+     * @param key The key to be searched.
+     * @param hash The hash of the key.
+     * @param[out] value The value associated with the key, only written if the key is found.
+     * @param[out] found Whether the key is found.
+     * @return False if the read raced with a writer (or the bucket was retired) and must be retried.
+     */
+    auto OptimisticFind(const K &key, size_t hash, V &value, bool *found) const -> bool;
+
+    /**
+     * @brief Find the value associated with the given key in the bucket without copying it.
+     * @param key The key to be searched.
+     * @param hash The hash of the key.
+     * @return The stored value, or nullptr if the key is not found.
+     */
+    auto FindPtr(const K &key, size_t hash) -> V *;
 
     /**
      *
@@ -140,9 +531,10 @@ class ExtendibleHashTable : public HashTable<K, V> {
      *
      * @brief Given the key, remove the corresponding key-value pair in the bucket.
      * @param key The key to be deleted.
+     * @param hash The hash of the key.
      * @return True if the key exists, false otherwise.
      */
-    auto Remove(const K &key) -> bool;
+    auto Remove(const K &key, size_t hash) -> bool;
 
     /**
      *
@@ -152,27 +544,377 @@ class ExtendibleHashTable : public HashTable<K, V> {
      *      1. If a key already exists, the value should be updated.
      *      2. If the bucket is full, do nothing and return false.
      * @param key The key to be inserted.
+     * @param hash The hash of the key.
      * @param value The value to be inserted.
      * @return True if the key-value pair is inserted, false otherwise.
      */
-    auto Insert(const K &key, const V &value) -> bool;
+    auto Insert(const K &key, size_t hash, const V &value) -> bool;
+
+    /**
+     * @brief Insert the given key-value pair into the bucket, forwarding (moving) the arguments.
+     * @param key The key to be inserted.
+     * @param hash The hash of the key.
+     * @param value The value to be inserted.
+     * @param assign Whether to overwrite the value if the key already exists.
+     * @param[out] inserted Whether a new pair was added.
+     * @return The stored value, or nullptr if the key is absent and the bucket is full, in which
+     * case neither argument has been moved from.
+     */
+    template <typename KArg, typename VArg>
+    auto Put(KArg &&key, size_t hash, VArg &&value, bool assign, bool *inserted) -> V *;
+
+    /**
+     * @brief Move every item of other, the split image of this bucket, into this bucket and
+     * decrement the local depth. The caller guarantees that they fit; no duplicate check is needed
+     * since the two buckets hold disjoint keys.
+     * @param other The bucket to be merged into this one.
+     */
+    void Absorb(Bucket *other);
+
+    /**
+     * @brief Move every item of other into this empty bucket, which is not yet reachable and has
+     * the same depth and prefix. For the integral and pointer types that optimistic readers see,
+     * moving leaves other intact.
+     * @param other The bucket this one replaces.
+     */
+    void MoveItemsFrom(Bucket *other);
+
+    /**
+     * @brief First half of an in-place split: move the items whose hash has bit GetDepth() set into
+     * image, a new bucket that is not yet reachable. No duplicate check is needed. The moved-from
+     * items stay counted until CompleteSplit; for the integral and pointer types that optimistic
+     * readers see, moving leaves them intact.
+     * @param image The empty bucket that receives the upper half.
+     */
+    void MoveSplitImage(Bucket *image);
+
+    /**
+     * @brief Second half of an in-place split, once the directory points to the image: drop the
+     * moved items and increment the local depth.
+     */
+    void CompleteSplit();
+
+    /**
+     * @brief Mark the bucket as merged into its split image. Its version stays odd forever, so
+     * optimistic readers that still reach it through a stale directory slot retry instead of
+     * reading it.
+     */
+    void Retire();
+
+    /** @brief Append the raw tag/key/value/hash arrays of the bucket to an image. */
+    void WriteImage(std::ostream &out) const;
+
+    /**
+     * @brief Fill an empty bucket with count items from the raw arrays of an image.
+     * @return The number of bytes consumed.
+     */
+    auto ReadImage(const char *data, size_t count) -> size_t;
+
+    /**
+     * @brief Check the raw arrays of count items in an image before they are read: every hash must
+     * have the given low depth bits and every tag must be the tag of its hash.
+     */
+    static auto CheckImage(const char *data, size_t count, int depth, size_t prefix) -> bool;
 
    private:
     // TODO(student): You may add additional private members and helper functions
+    /** @brief The one-byte fingerprint stored in the tag array for a hash. */
+    static inline auto TagOf(size_t hash) -> uint8_t {
+      // The directory consumes the low bits, so the tag is taken from the top of a mixed hash.
+      return static_cast<uint8_t>((hash * 0x9E3779B97F4A7C15ULL) >> 56);
+    }
+
+    /** Whether keys and values are stored interleaved as items; see the class comment. */
+    static constexpr bool INTERLEAVED =
+        (std::is_integral_v<K> || std::is_pointer_v<K>) && (std::is_integral_v<V> || std::is_pointer_v<V>);
+
+    struct Item {
+      K key_;
+      V value_;
+    };
+
+    inline auto KeyAt(size_t i) -> K & {
+      if constexpr (INTERLEAVED) {
+        return items_[i].key_;
+      } else {
+        return keys_[i];
+      }
+    }
+    inline auto KeyAt(size_t i) const -> const K & { return const_cast<Bucket *>(this)->KeyAt(i); }
+    inline auto ValueAt(size_t i) -> V & {
+      if constexpr (INTERLEAVED) {
+        return items_[i].value_;
+      } else {
+        return values_[i];
+      }
+    }
+    inline auto ValueAt(size_t i) const -> const V & { return const_cast<Bucket *>(this)->ValueAt(i); }
+
+    /**
+     * @brief Return the slot holding key among the first count slots, or count if absent.
+     * @tparam LATCH_FREE Whether the caller does not hold the latch, in which case tags and keys are
+     * read with relaxed atomic loads (see LoadShared).
+     */
+    template <bool LATCH_FREE = false>
+    auto FindSlot(const K &key, uint8_t tag, size_t count) const -> size_t;
+
+    /**
+     * @brief Store a tag, key or value of a bucket that optimistic readers may be loading at the
+     * same time. When OPTIMISTIC_FIND holds this is a relaxed atomic store, so that the reader's
+     * loads are not a data race; the version counter still decides whether what it read is used.
+     */
+    template <typename T, typename U>
+    static inline void StoreShared(T &field, U &&value) {
+      if constexpr (OPTIMISTIC_FIND) {
+        __atomic_store_n(&field, static_cast<T>(value), __ATOMIC_RELAXED);
+      } else {
+        field = std::forward<U>(value);
+      }
+    }
+
+    /** @brief Load a field written with StoreShared without holding the latch. */
+    template <typename T>
+    static inline auto LoadShared(const T &field) -> T {
+      if constexpr (OPTIMISTIC_FIND) {
+        return __atomic_load_n(&field, __ATOMIC_RELAXED);
+      } else {
+        return field;  // Never called without the latch; see OPTIMISTIC_FIND
+      }
+    }
+
+    /** @brief Copy the tag group starting at tags_[group] with relaxed atomic word loads. */
+    inline void LoadTagGroup(size_t group, uint8_t *out) const {
+      using TagWord __attribute__((may_alias)) = uint64_t;
+      for (size_t i = 0; i < TAG_GROUP_SIZE; i += sizeof(TagWord)) {
+        TagWord word = __atomic_load_n(reinterpret_cast<const TagWord *>(&tags_[group + i]), __ATOMIC_RELAXED);
+        memcpy(out + i, &word, sizeof(word));
+      }
+    }
+
+    /** @brief Append an item without a duplicate check. The bucket must not be full. */
+    void Append(uint8_t tag, K &&key, V &&value, size_t hash);
+
+    /** @brief Change the local depth; only called between BeginWrite and EndWrite. */
+    inline void IncrementDepth() { depth_.store(GetDepth() + 1, std::memory_order_relaxed); }
+    inline void DecrementDepth() {
+      int depth = GetDepth() - 1;
+      depth_.store(depth, std::memory_order_relaxed);
+      prefix_.store(GetPrefix() & ((1UL << depth) - 1), std::memory_order_relaxed);
+    }
+
+    void BeginWrite();
+    void EndWrite();
+
     size_t size_;
-    int depth_{0};
-    std::list<std::pair<K, V>> list_;
+    std::atomic<int> depth_;
+    std::atomic<size_t> prefix_;
+    std::atomic<size_t> count_{0};      // Only the first count_ slots are valid
+    std::atomic<uint64_t> version_{0};  // Odd while a writer is modifying the bucket
+    /** Offsets of the arrays in a bucket's storage, and its total size. */
+    struct Layout {
+      size_t num_tags_;
+      size_t items_offset_;
+      size_t keys_offset_;
+      size_t values_offset_;
+      size_t hashes_offset_;
+      size_t bytes_;
+    };
+
+    static auto ComputeLayout(size_t size) -> Layout;
+
+    // The arrays below all point into the storage passed at construction: the tags, padded to whole
+    // groups, then either the items or the keys and the values, then the hashes.
+    uint8_t *tags_;
+    Item *items_{nullptr};
+    K *keys_{nullptr};
+    V *values_{nullptr};
+    size_t *hashes_;
+    mutable std::shared_mutex latch_;
   };
 
  private:
+  /**
+   * The buckets of a table, named by 32-bit indices so that a directory slot is half the size of a
+   * pointer. Buckets are constructed in place in slabs owned by the pool; slab s holds the 2^s
+   * buckets with indices [2^s, 2^(s+1)), followed by the storage of those buckets, so a slab is one
+   * allocation of the table's MemoryPolicy. Only a bucket grown beyond the bucket size (see
+   * SetMaxBucketCapacity) has storage of its own. Slabs are never moved or freed before the pool, so an
+   * index can be translated without latches. Index 0 is never handed out.
+   *
+   * Allocate and Free must be serialized by the caller; Get may run concurrently with both.
+   */
+  class BucketPool {
+   public:
+    BucketPool(size_t bucket_size, const MemoryPolicy &memory_policy);
+
+    /** @brief Destroy every bucket that has not been freed, and release the slabs. */
+    ~BucketPool();
+
+    DISALLOW_COPY_AND_MOVE(BucketPool);
+
+    /**
+     * @brief Construct a bucket, reusing the index of a freed one if possible.
+     * @param capacity The maximum number of items; at least the bucket size.
+     * @return The index of the new bucket.
+     */
+    auto Allocate(int depth, size_t prefix, size_t capacity) -> uint32_t;
+
+    /** @brief Destroy a bucket and make its index available to Allocate. */
+    void Free(uint32_t index);
+
+    /** @brief Get the bucket with the given index. */
+    inline auto Get(uint32_t index) const -> Bucket * {
+      int slab = 31 - __builtin_clz(index);
+      return slabs_[slab].load(std::memory_order_acquire) + (index - (1U << slab));
+    }
+
+   private:
+    static constexpr int NUM_SLABS = 32;
+
+    /** @brief Destroy a bucket, and free its storage if it does not live in its slab. */
+    void Destroy(uint32_t index);
+
+    /** @brief Get the size of slab s: the buckets, padded to a cache line, then their storage. */
+    inline auto SlabBytes(int slab) const -> size_t { return BucketsBytes(slab) + (storage_stride_ << slab); }
+
+    inline auto BucketsBytes(int slab) const -> size_t {
+      return ((sizeof(Bucket) << slab) + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    }
+
+    size_t bucket_size_;
+    size_t storage_stride_;  // Bucket::StorageSize(bucket_size_), rounded up to a cache line
+    MemoryPolicy memory_policy_;
+    std::array<std::atomic<Bucket *>, NUM_SLABS> slabs_{};
+    uint32_t next_{1};            // The smallest index never handed out
+    std::vector<uint32_t> free_;  // Indices of freed buckets
+  };
+
   // TODO(student): You may add additional private members and helper functions and remove the ones
   // you don't need.
 
   int global_depth_{0};  // The global depth of the directory
   size_t bucket_size_;   // The size of a bucket
+  Hash hash_fn_;         // The hasher for keys, called once per operation
   int num_buckets_{1};   // The number of buckets in the hash table
-  mutable std::mutex latch_;
-  std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
+  size_t max_bucket_capacity_;  // See SetMaxBucketCapacity; only changed under latch_ held exclusively
+  /**
+   * Directory latch. Find, Remove and the fast path of Insert hold it shared and rely on the bucket
+   * latches; splitting a bucket and doubling the directory hold it exclusively. Copying slots into a
+   * doubled directory only needs it shared (see MigrateStep).
+   */
+  mutable std::shared_mutex latch_;
+
+  /**
+   * The directory: 2^global_depth_ slots, each holding the pool index of a bucket. A directory is
+   * never resized in place; doubling builds a new one and publishes it through dir_.
+   *
+   * A doubled directory starts out with every slot 0 and is filled in incrementally. Until then a
+   * slot i holding 0 stands for slot i mod 2^(global_depth_ - 1) of prev_, the directory it doubled.
+   * Splits and merges always write every slot they repoint, so a slot that is still 0 has never
+   * diverged from prev_.
+   */
+  struct Directory {
+    Directory(int global_depth, const MemoryPolicy &memory_policy, const Directory *prev = nullptr)
+        : global_depth_(global_depth),
+          slots_(1UL << global_depth, PolicyAllocator<std::atomic<uint32_t>>(memory_policy)),
+          prev_(prev) {}
+
+    /** @brief Get the pool index of the bucket slot index points to. */
+    inline auto Lookup(size_t index) const -> uint32_t {
+      uint32_t bucket = slots_[index].load(std::memory_order_acquire);
+      if (bucket == 0) {
+        bucket = prev_->slots_[index & (prev_->slots_.size() - 1)].load(std::memory_order_acquire);
+      }
+      return bucket;
+    }
+
+    int global_depth_;
+    PolicyVector<std::atomic<uint32_t>> slots_;
+    const Directory *prev_;
+  };
+
+  /** Number of keys FindBatch and InsertBatch move through the prefetch pipeline together. */
+  static constexpr size_t BATCH_GROUP_SIZE = 16;
+
+  /** Number of slots of the previous directory each Insert copies into a doubled directory. */
+  static constexpr size_t MIGRATE_CHUNK = 256;
+
+  /** How many levels beyond the minimum BulkLoad deepens the directory before falling back to InsertBatch. */
+  static constexpr int BULK_LOAD_EXTRA_DEPTH = 4;
+
+  /** The largest global depth LoadImage and Reserve accept. */
+  static constexpr uint32_t MAX_IMAGE_DEPTH = 32;
+
+  /** The bucket fill, in percent, Reserve splits buckets down to: about what inserts settle at (ln 2). */
+  static constexpr size_t RESERVE_LOAD_PERCENT = 69;
+
+  /** Directory slots per bucket beyond which a full bucket grows rather than doubling the directory. */
+  static constexpr size_t MAX_SLOTS_PER_BUCKET = 8;
+
+  /**
+   * Whether Find can run without latches (see Find). The latch-free reader loads tags, keys and
+   * values while writers store them, so both sides use relaxed atomic accesses (see
+   * Bucket::StoreShared); that needs K and V to be integral or pointer types.
+   */
+  static constexpr bool OPTIMISTIC_FIND =
+      (std::is_integral_v<K> || std::is_pointer_v<K>) && (std::is_integral_v<V> || std::is_pointer_v<V>);
+
+  /** Whether the table can be saved to and loaded from a raw image (see SaveImage). */
+  static constexpr bool IMAGE_SUPPORTED = std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+
+  /** Identifies an image written by SaveImage, and its layout version. */
+  static constexpr uint64_t IMAGE_MAGIC = 0x3147414D49485442ULL;  // "BTHIMAG1"
+
+  /** The fixed-size header at the start of an image. */
+  struct ImageHeader {
+    uint64_t magic_;
+    uint32_t key_size_;
+    uint32_t value_size_;
+    uint64_t bucket_size_;
+    uint32_t global_depth_;
+    uint32_t num_buckets_;
+  };
+
+  /** Per-bucket header in an image, followed by the bucket's arrays. */
+  struct ImageBucketHeader {
+    uint32_t depth_;
+    uint32_t count_;
+    uint64_t prefix_;
+  };
+
+  MemoryPolicy memory_policy_;    // Backs every directory and bucket slab
+  BucketPool pool_;               // Owns every bucket, live or retired
+  std::atomic<Directory *> dir_;  // The directory of the hash table, readable without latch_
+  std::vector<int> buckets_at_depth_{1};  // buckets_at_depth_[d]: the number of buckets of local depth d
+
+  /** The hot-path counters behind GetStats; empty when statistics are compiled out. */
+  struct StatCounters {
+    StatCounter finds_;
+    StatCounter hits_;
+    StatCounter inserts_;
+    StatCounter splits_;
+    StatCounter doublings_;
+    StatCounter growths_;
+    LatchStatCounters latch_;
+  };
+  mutable StatCounters stats_;
+
+  /**
+   * The directory dir_ was doubled from while its slots are still being copied, or nullptr. Every
+   * Insert claims the next MIGRATE_CHUNK slots through migrate_cursor_; the directory is retired by
+   * the first exclusive section after migrated_ reaches its size.
+   */
+  Directory *migrating_from_{nullptr};
+  std::atomic<size_t> migrate_cursor_{0};
+  std::atomic<size_t> migrated_{0};
+
+  /**
+   * Directories and buckets unlinked by a resize, split or merge, tagged with their retire epoch.
+   * An optimistic Find may still be reading them, so they are only freed once EpochManager reports
+   * that every reader of that epoch has finished. Types without optimistic Find free them at once.
+   */
+  std::vector<std::pair<uint64_t, std::unique_ptr<Directory>>> retired_directories_;
+  std::vector<std::pair<uint64_t, uint32_t>> retired_buckets_;
 
   // The following functions are completely optional, you can delete them if you have your own ideas.
 
@@ -182,11 +924,87 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
  
   auto DirectoryExtension()->void;
-  auto SplitTheBucket(const K &key)->void;
+  auto SplitTheBucket(size_t dir_index)->void;
+
+  /**
+   * @brief Whether a full bucket at the global depth should grow instead of doubling the
+   * directory (see SetMaxBucketCapacity).
+   */
+  auto ShouldGrow(const Bucket *bucket) const -> bool;
+
+  /** @brief Replace the bucket dir_index points to with one of twice its capacity. */
+  void GrowBucket(size_t dir_index);
+
+  /** @brief Halve the directory; no bucket may have a local depth equal to the global depth. */
+  void DirectoryShrink();
+
+  /** @brief Copy the next MIGRATE_CHUNK slots into a doubled directory. Must hold latch_ (shared or exclusive). */
+  void MigrateStep();
+
+  /** @brief Copy slot index of migrating_from_ into both of its slots in dir_ unless already set. */
+  void MigrateSlot(size_t index);
+
+  /**
+   * @brief Retire migrating_from_ once all of its slots are copied; if finish is true, first copy
+   * the remaining ones. Must hold latch_ exclusively.
+   */
+  void EndMigration(bool finish);
+
+  /**
+   * @brief Whether the bucket at dir_index and its split image fit together in half a bucket.
+   * Must hold latch_ (shared or exclusive).
+   */
+  auto ShouldMerge(size_t dir_index) const -> bool;
+
+  /**
+   * @brief Merge the bucket at dir_index with its split image for as long as ShouldMerge holds,
+   * then shrink the directory as far as possible. Must hold latch_ exclusively.
+   */
+  void MergeBuckets(size_t dir_index);
+
+  /** The fewest directory slots ParallelForEach gives a thread; smaller tables use fewer threads. */
+  static constexpr size_t MIN_SLOTS_PER_THREAD = 1024;
+
+  /**
+   * @brief Call visit with every bucket, once each from its canonical slot (the slot equal to its
+   * prefix). With more than one thread, each thread visits a contiguous range of slots and the
+   * calling thread joins them before returning. Must hold latch_ (shared or exclusive).
+   */
+  void VisitBuckets(const std::function<void(const Bucket &)> &visit, size_t num_threads) const;
+
+  /** @brief Retire an unlinked bucket / directory, and free the retired ones no reader can see. */
+  void RetireBucket(uint32_t bucket);
+  void RetireDirectory(Directory *dir);
+  void ReclaimRetired();
+
+  /**
+   * @brief Replace the whole table with a directory built by BulkLoad or LoadImage, retiring the
+   * current directory and all of its buckets. Must hold latch_ exclusively.
+   */
+  void ReplaceDirectory(Directory *dir);
+
+  /**
+   * @brief Insert, or update if assign is set, a pair in the table. All the Insert flavors end up
+   * here; the arguments are forwarded into the bucket, so rvalues are moved rather than copied.
+   * @param[out] inserted Whether a new pair was added.
+   * @return The stored value.
+   */
+  template <typename KArg, typename VArg>
+  auto Put(KArg &&key, VArg &&value, bool assign, bool *inserted) -> V &;
+
+  /**
+   * @brief The slow path of Put: take the directory latch exclusively and split until the pair
+   * fits. Must not hold latch_.
+   */
+  template <typename KArg, typename VArg>
+  auto PutExclusive(KArg &&key, size_t hash, VArg &&value, bool assign, bool *inserted) -> V &;
+
+  /** @brief The non-template part of Emplace. */
+  auto EmplaceValue(const K &key, V &&value) -> bool;
  
-  /*****************************************************************
-   * Must acquire latch_ first before calling the below functions. *
-   *****************************************************************/
+  /***************************************************************************************
+   * Must acquire latch_ (shared or exclusive) first before calling the below functions. *
+   **************************************************************************************/
 
   /**
    * @brief For the given key, return the entry index in the directory where the key hashes to.
@@ -195,6 +1013,15 @@ class ExtendibleHashTable : public HashTable<K, V> {
    */
   auto IndexOf(const K &key) -> size_t;
 
+  /** @brief Return the directory index for a hash computed with hash_fn_. */
+  inline auto IndexOfHash(size_t hash) const -> size_t { return hash & ((1UL << global_depth_) - 1); }
+
+  /** @brief Get the pool index of the bucket the given directory index points to. */
+  inline auto SlotAt(size_t dir_index) const -> uint32_t { return dir_.load(std::memory_order_relaxed)->Lookup(dir_index); }
+
+  /** @brief Get the bucket the given directory index points to. */
+  inline auto BucketAt(size_t dir_index) const -> Bucket * { return pool_.Get(SlotAt(dir_index)); }
+
   auto GetGlobalDepthInternal() const -> int;
   auto GetLocalDepthInternal(int dir_index) const -> int;
   auto GetNumBucketsInternal() const -> int;
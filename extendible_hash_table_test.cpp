@@ -0,0 +1,207 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/hash/extendible_hash_table_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/extendible_hash_table.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * Latch-free readers look up keys that are already in the table while a writer keeps splitting
+ * buckets and doubling the directory underneath them. Every lookup must see the key with its value.
+ */
+TEST(ExtendibleHashTableTest, ConcurrentReadersDuringSplits) {
+  const int num_keys = 100000;
+  const int num_readers = 4;
+  ExtendibleHashTable<int, int> table(4);
+  std::atomic<int> inserted{0};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int r = 0; r < num_readers; r++) {
+    readers.emplace_back([&table, &inserted, &done, r] {
+      uint32_t seed = r + 1;
+      while (!done.load()) {
+        int limit = inserted.load();
+        if (limit == 0) {
+          continue;
+        }
+        seed = seed * 1664525 + 1013904223;
+        int key = static_cast<int>(seed % limit);
+        int value;
+        ASSERT_TRUE(table.Find(key, value)) << key;
+        ASSERT_EQ(key * 7, value);
+      }
+    });
+  }
+
+  for (int i = 0; i < num_keys; i++) {
+    table.Insert(i, i * 7);
+    inserted.store(i + 1);
+  }
+  done.store(true);
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_GT(table.GetGlobalDepth(), 10);
+}
+
+namespace {
+
+const char *const IMAGE_PATH = "extendible_hash_table_test.image";
+
+auto ReadFile(const char *path) -> std::string {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+void WriteFile(const char *path, const std::string &data) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(data.data(), data.size());
+}
+
+/**
+ * Save a table holding keys 0 and 1 in two one-item buckets. std::hash is the identity, so the
+ * directory has global depth 1, and the image is laid out as: the 32-byte header, two 4-byte slots,
+ * then per bucket a 16-byte header {depth, count, prefix} and its tag, key, value and hash.
+ */
+auto SaveTwoBucketImage() -> std::string {
+  ExtendibleHashTable<int, int> table(1);
+  table.Insert(0, 10);
+  table.Insert(1, 11);
+  table.SaveImage(IMAGE_PATH);
+  std::string image = ReadFile(IMAGE_PATH);
+  EXPECT_EQ(106, image.size());
+  return image;
+}
+
+const size_t BUCKET_0 = 40;       // Header of the first bucket in the image
+const size_t BUCKET_1 = 73;       // Header of the second bucket
+const size_t BUCKET_HEADER = 16;  // Size of a bucket header
+const size_t BUCKET_ITEMS = 17;   // Size of the arrays of a one-item bucket
+
+/** Load image into a table that already holds a key, and check it was rejected and left intact. */
+void ExpectRejected(const std::string &image) {
+  WriteFile(IMAGE_PATH, image);
+  ExtendibleHashTable<int, int> table(1);
+  table.Insert(5, 50);
+  EXPECT_THROW(table.LoadImage(IMAGE_PATH), std::runtime_error);
+  int value;
+  EXPECT_TRUE(table.Find(5, value));
+  EXPECT_EQ(1, table.GetNumBuckets());
+}
+
+}  // namespace
+
+TEST(ExtendibleHashTableTest, ImageRoundTrip) {
+  ExtendibleHashTable<int, int> table(4);
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 10000; i++) {
+    pairs.emplace_back(i, i * 3);
+  }
+  table.BulkLoad(pairs.begin(), pairs.end());
+  table.SaveImage(IMAGE_PATH);
+
+  ExtendibleHashTable<int, int> loaded(4);
+  loaded.Insert(-1, 1);
+  loaded.LoadImage(IMAGE_PATH);
+  EXPECT_EQ(table.GetGlobalDepth(), loaded.GetGlobalDepth());
+  EXPECT_EQ(table.GetNumBuckets(), loaded.GetNumBuckets());
+  int value;
+  EXPECT_FALSE(loaded.Find(-1, value));
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_TRUE(loaded.Find(i, value));
+    ASSERT_EQ(i * 3, value);
+  }
+  for (int i = 10000; i < 20000; i++) {
+    loaded.Insert(i, i * 3);
+  }
+  for (int i = 0; i < 20000; i++) {
+    ASSERT_TRUE(loaded.Find(i, value));
+  }
+  std::remove(IMAGE_PATH);
+}
+
+TEST(ExtendibleHashTableTest, ImageRejectsDirectoryDisagreeingWithDepth) {
+  // The first bucket claims depth 0, i.e. both slots, but slot 1 names the second bucket
+  std::string image = SaveTwoBucketImage();
+  uint32_t depth = 0;
+  memcpy(&image[BUCKET_0], &depth, sizeof(depth));
+  ExpectRejected(image);
+  std::remove(IMAGE_PATH);
+}
+
+TEST(ExtendibleHashTableTest, ImageRejectsItemInWrongBucket) {
+  // Swap the items of the two buckets: each hash and tag still agree, but not with the prefix
+  std::string image = SaveTwoBucketImage();
+  std::string first = image.substr(BUCKET_0 + BUCKET_HEADER, BUCKET_ITEMS);
+  image.replace(BUCKET_0 + BUCKET_HEADER, BUCKET_ITEMS, image.substr(BUCKET_1 + BUCKET_HEADER, BUCKET_ITEMS));
+  image.replace(BUCKET_1 + BUCKET_HEADER, BUCKET_ITEMS, first);
+  ExpectRejected(image);
+  std::remove(IMAGE_PATH);
+}
+
+TEST(ExtendibleHashTableTest, ImageRejectsWrongTag) {
+  std::string image = SaveTwoBucketImage();
+  image[BUCKET_0 + BUCKET_HEADER] ^= 1;
+  ExpectRejected(image);
+  std::remove(IMAGE_PATH);
+}
+
+TEST(ExtendibleHashTableTest, ImageRejectsBucketAboveMaxCapacity) {
+  // std::hash is the identity: keys i << 12 share their low 12 bits, so their bucket grows
+  ExtendibleHashTable<int, int> table(4);
+  table.SetMaxBucketCapacity(64);
+  for (int i = 0; i < 32; i++) {
+    table.Insert(i << 12, i);
+  }
+  table.SaveImage(IMAGE_PATH);
+
+  ExtendibleHashTable<int, int> small(4);
+  EXPECT_THROW(small.LoadImage(IMAGE_PATH), std::runtime_error);
+  ExtendibleHashTable<int, int> large(4);
+  large.SetMaxBucketCapacity(64);
+  large.LoadImage(IMAGE_PATH);
+  int value;
+  for (int i = 0; i < 32; i++) {
+    ASSERT_TRUE(large.Find(i << 12, value));
+    ASSERT_EQ(i, value);
+  }
+  std::remove(IMAGE_PATH);
+}
+
+TEST(ExtendibleHashTableTest, BulkLoadIteratorRange) {
+  std::map<int, int> pairs;
+  for (int i = 0; i < 1000; i++) {
+    pairs[i] = -i;
+  }
+  ExtendibleHashTable<int, int> table(4);
+  table.BulkLoad(pairs.begin(), pairs.end());
+  int value;
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(table.Find(i, value));
+    ASSERT_EQ(-i, value);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_bucket_page.cpp
+//
+// Identification: src/storage/page/extendible_htable_bucket_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_htable_bucket_page.h"
+
+namespace bustub {
+
+/**
+ * @brief 初始化新分配的桶页面
+ *
+ * @param max_size 桶的最大元素数量，不能超过一个页面能放下的数量
+ */
+template <typename K, typename V>
+void ExtendibleHTableBucketPage<K, V>::Init(uint32_t max_size) {
+  BUSTUB_ASSERT(max_size > 0 && max_size <= (HTableBucketArraySize<K, V>()), "invalid bucket max size");
+  size_ = 0;
+  max_size_ = max_size;
+}
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::IndexOf(const K &key) const -> uint32_t {
+  for (uint32_t i = 0; i < size_; i++) {
+    if (array_[i].first == key) {
+      return i;
+    }
+  }
+  return size_;
+}
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::Lookup(const K &key, V &value) const -> bool {
+  uint32_t idx = IndexOf(key);
+  if (idx == size_) {
+    return false;
+  }
+  value = array_[idx].second;
+  return true;
+}
+
+/**
+ * @brief 插入键值对，键已存在时更新它的值
+ *
+ * @return true 如果插入或更新成功；键不存在且桶已满时返回 false
+ */
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::Insert(const K &key, const V &value) -> bool {
+  uint32_t idx = IndexOf(key);
+  if (idx != size_) {
+    array_[idx].second = value;
+    return true;
+  }
+  if (IsFull()) {
+    return false;
+  }
+  Append(key, value);
+  return true;
+}
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::Remove(const K &key) -> bool {
+  uint32_t idx = IndexOf(key);
+  if (idx == size_) {
+    return false;
+  }
+  RemoveAt(idx);
+  return true;
+}
+
+/**
+ * @brief 删除指定位置的元素，用最后一个元素填补空位，保持元素连续存放
+ */
+template <typename K, typename V>
+void ExtendibleHTableBucketPage<K, V>::RemoveAt(uint32_t bucket_idx) {
+  BUSTUB_ASSERT(bucket_idx < size_, "bucket index out of range");
+  array_[bucket_idx] = array_[size_ - 1];
+  size_--;
+}
+
+template <typename K, typename V>
+void ExtendibleHTableBucketPage<K, V>::Append(const K &key, const V &value) {
+  BUSTUB_ASSERT(!IsFull(), "bucket page is full");
+  array_[size_++] = {key, value};
+}
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::KeyAt(uint32_t bucket_idx) const -> K { return array_[bucket_idx].first; }
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::ValueAt(uint32_t bucket_idx) const -> V { return array_[bucket_idx].second; }
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::Size() const -> uint32_t { return size_; }
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::MaxSize() const -> uint32_t { return max_size_; }
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::IsFull() const -> bool { return size_ == max_size_; }
+
+template <typename K, typename V>
+auto ExtendibleHTableBucketPage<K, V>::IsEmpty() const -> bool { return size_ == 0; }
+
+// ========================== 模板类显式实例化 ==========================
+template class ExtendibleHTableBucketPage<int, int>;
+template class ExtendibleHTableBucketPage<int64_t, int64_t>;
+
+}  // namespace bustub
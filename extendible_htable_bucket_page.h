@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_bucket_page.h
+//
+// Identification: src/include/storage/page/extendible_htable_bucket_page.h
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Bucket page format:
+ *  ----------------------------------------------------------------------------
+ * | METADATA | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------------
+ *
+ * Metadata format (size in byte, 8 bytes in total):
+ *  --------------------------------
+ * | CurrentSize (4) | MaxSize (4)
+ *  --------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+static constexpr uint64_t HTABLE_BUCKET_PAGE_METADATA_SIZE = sizeof(uint32_t) * 2;
+
+/** @brief The number of key-value pairs that fit in one bucket page. */
+template <typename K, typename V>
+constexpr auto HTableBucketArraySize() -> uint64_t {
+  return (BUSTUB_PAGE_SIZE - HTABLE_BUCKET_PAGE_METADATA_SIZE) / sizeof(std::pair<K, V>);
+}
+
+/**
+ * Bucket page for extendible hash table. The pairs are stored unordered and contiguously, like the
+ * entries of an in-memory bucket; keys are unique within the page.
+ *
+ * The page is a plain byte image written to disk, so K and V must be trivially copyable.
+ */
+template <typename K, typename V>
+class ExtendibleHTableBucketPage {
+  static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                "bucket pages store keys and values as raw bytes");
+
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  ExtendibleHTableBucketPage() = delete;
+  DISALLOW_COPY_AND_MOVE(ExtendibleHTableBucketPage);
+
+  /**
+   * After creating a new bucket page from buffer pool, must call initialize
+   * method to set default values
+   * @param max_size Max size of the bucket array
+   */
+  void Init(uint32_t max_size = HTableBucketArraySize<K, V>());
+
+  /**
+   * Lookup a key
+   *
+   * @param key key to lookup
+   * @param[out] value value to set
+   * @return true if the key is found
+   */
+  auto Lookup(const K &key, V &value) const -> bool;
+
+  /**
+   * Attempts to insert a key and value in the bucket. If the key already exists its value is
+   * updated, like ExtendibleHashTable::Bucket::Insert.
+   *
+   * @param key key to insert
+   * @param value value to insert
+   * @return true if inserted or updated, false if the key is absent and the bucket is full
+   */
+  auto Insert(const K &key, const V &value) -> bool;
+
+  /**
+   * Removes a key and value.
+   *
+   * @return true if removed, false if not found
+   */
+  auto Remove(const K &key) -> bool;
+
+  /**
+   * Removes the entry at bucket_idx; the last entry takes its place.
+   *
+   * @param bucket_idx the location to remove
+   */
+  void RemoveAt(uint32_t bucket_idx);
+
+  /**
+   * Appends a pair without checking for duplicates; the bucket must not be full.
+   */
+  void Append(const K &key, const V &value);
+
+  /**
+   * @brief Gets the key at an index in the bucket.
+   */
+  auto KeyAt(uint32_t bucket_idx) const -> K;
+
+  /**
+   * Gets the value at an index in the bucket.
+   */
+  auto ValueAt(uint32_t bucket_idx) const -> V;
+
+  /**
+   * @return number of pairs in the bucket
+   */
+  auto Size() const -> uint32_t;
+
+  /**
+   * @return the maximum number of pairs the bucket can hold
+   */
+  auto MaxSize() const -> uint32_t;
+
+  /**
+   * @return whether the bucket is full
+   */
+  auto IsFull() const -> bool;
+
+  /**
+   * @return whether the bucket is empty
+   */
+  auto IsEmpty() const -> bool;
+
+ private:
+  /** @brief Return the index of key, or size_ if absent. */
+  auto IndexOf(const K &key) const -> uint32_t;
+
+  uint32_t size_;
+  uint32_t max_size_;
+  std::pair<K, V> array_[HTableBucketArraySize<K, V>()];
+};
+
+}  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_directory_page.cpp
+//
+// Identification: src/storage/page/extendible_htable_directory_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_htable_directory_page.h"
+
+#include <cstring>
+
+namespace bustub {
+
+/**
+ * @brief 初始化新分配的目录页面：全局深度为 0，所有槽位为空
+ *
+ * @param max_depth 目录允许的最大全局深度
+ */
+void ExtendibleHTableDirectoryPage::Init(uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= HTABLE_DIRECTORY_MAX_DEPTH, "directory max depth too large");
+  max_depth_ = max_depth;
+  global_depth_ = 0;
+  memset(local_depths_, 0, sizeof(local_depths_));
+  for (page_id_t &page_id : bucket_page_ids_) {
+    page_id = INVALID_PAGE_ID;
+  }
+}
+
+auto ExtendibleHTableDirectoryPage::HashToBucketIndex(uint32_t hash) const -> uint32_t {
+  return hash & GetGlobalDepthMask();
+}
+
+auto ExtendibleHTableDirectoryPage::GetBucketPageId(uint32_t bucket_idx) const -> page_id_t {
+  BUSTUB_ASSERT(bucket_idx < Size(), "bucket index out of range");
+  return bucket_page_ids_[bucket_idx];
+}
+
+void ExtendibleHTableDirectoryPage::SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+  BUSTUB_ASSERT(bucket_idx < Size(), "bucket index out of range");
+  bucket_page_ids_[bucket_idx] = bucket_page_id;
+}
+
+/**
+ * @brief 分裂镜像是局部深度最高位不同的那个槽位
+ */
+auto ExtendibleHTableDirectoryPage::GetSplitImageIndex(uint32_t bucket_idx) const -> uint32_t {
+  uint32_t local_depth = GetLocalDepth(bucket_idx);
+  BUSTUB_ASSERT(local_depth > 0, "a bucket of local depth 0 has no split image");
+  return bucket_idx ^ (1U << (local_depth - 1));
+}
+
+auto ExtendibleHTableDirectoryPage::GetGlobalDepthMask() const -> uint32_t { return (1U << global_depth_) - 1; }
+
+auto ExtendibleHTableDirectoryPage::GetLocalDepthMask(uint32_t bucket_idx) const -> uint32_t {
+  return (1U << GetLocalDepth(bucket_idx)) - 1;
+}
+
+auto ExtendibleHTableDirectoryPage::GetGlobalDepth() const -> uint32_t { return global_depth_; }
+
+auto ExtendibleHTableDirectoryPage::GetMaxDepth() const -> uint32_t { return max_depth_; }
+
+/**
+ * @brief 全局深度加一
+ *
+ * 新增的上半部分槽位复制下半部分的桶页面和局部深度。
+ */
+void ExtendibleHTableDirectoryPage::IncrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ < max_depth_, "directory is already at its max depth");
+  uint32_t size = Size();
+  memcpy(local_depths_ + size, local_depths_, size * sizeof(local_depths_[0]));
+  memcpy(bucket_page_ids_ + size, bucket_page_ids_, size * sizeof(bucket_page_ids_[0]));
+  global_depth_++;
+}
+
+void ExtendibleHTableDirectoryPage::DecrGlobalDepth() {
+  BUSTUB_ASSERT(global_depth_ > 0, "directory is already at depth 0");
+  global_depth_--;
+}
+
+/**
+ * @brief 所有桶的局部深度都小于全局深度时，目录的上下两半相同，可以收缩
+ */
+auto ExtendibleHTableDirectoryPage::CanShrink() -> bool {
+  if (global_depth_ == 0) {
+    return false;
+  }
+  for (uint32_t i = 0; i < Size(); i++) {
+    if (local_depths_[i] == global_depth_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ExtendibleHTableDirectoryPage::Size() const -> uint32_t { return 1U << global_depth_; }
+
+auto ExtendibleHTableDirectoryPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+auto ExtendibleHTableDirectoryPage::GetLocalDepth(uint32_t bucket_idx) const -> uint32_t {
+  BUSTUB_ASSERT(bucket_idx < Size(), "bucket index out of range");
+  return local_depths_[bucket_idx];
+}
+
+void ExtendibleHTableDirectoryPage::SetLocalDepth(uint32_t bucket_idx, uint8_t local_depth) {
+  BUSTUB_ASSERT(bucket_idx < Size(), "bucket index out of range");
+  local_depths_[bucket_idx] = local_depth;
+}
+
+}  // namespace bustub
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_htable_header_page.cpp
+//
+// Identification: src/storage/page/extendible_htable_header_page.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/extendible_htable_header_page.h"
+
+namespace bustub {
+
+/**
+ * @brief 初始化新分配的头页面
+ *
+ * 所有目录页面都按需创建，初始时全部为 INVALID_PAGE_ID。
+ *
+ * @param max_depth 头页面使用的哈希高位位数
+ */
+void ExtendibleHTableHeaderPage::Init(uint32_t max_depth) {
+  BUSTUB_ASSERT(max_depth <= HTABLE_HEADER_MAX_DEPTH, "header max depth too large");
+  max_depth_ = max_depth;
+  for (page_id_t &page_id : directory_page_ids_) {
+    page_id = INVALID_PAGE_ID;
+  }
+}
+
+/**
+ * @brief 取哈希值的高 max_depth_ 位作为目录索引
+ *
+ * 目录页面使用哈希值的低位，两者互不重叠。
+ */
+auto ExtendibleHTableHeaderPage::HashToDirectoryIndex(uint32_t hash) const -> uint32_t {
+  if (max_depth_ == 0) {
+    return 0;
+  }
+  return hash >> (32 - max_depth_);
+}
+
+auto ExtendibleHTableHeaderPage::GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t {
+  BUSTUB_ASSERT(directory_idx < MaxSize(), "directory index out of range");
+  return directory_page_ids_[directory_idx];
+}
+
+void ExtendibleHTableHeaderPage::SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id) {
+  BUSTUB_ASSERT(directory_idx < MaxSize(), "directory index out of range");
+  directory_page_ids_[directory_idx] = directory_page_id;
+}
+
+auto ExtendibleHTableHeaderPage::MaxSize() const -> uint32_t { return 1U << max_depth_; }
+
+}  // namespace bustub
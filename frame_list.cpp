@@ -0,0 +1,149 @@
+#include "buffer/frame_list.h"
+
+#include <stdexcept>
+
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  FrameLists::FrameLists(size_t num_frames, size_t num_lists)
+      : num_frames_(num_frames), links_(num_frames + num_lists), sizes_(num_lists, 0)
+  {
+    // 空链表的哨兵指向自己
+    for (size_t list = 0; list < num_lists; list++)
+    {
+      size_t sentinel = Sentinel(list);
+      links_[sentinel].prev = sentinel;
+      links_[sentinel].next = sentinel;
+    }
+  }
+
+  auto FrameLists::Back(int list) const -> frame_id_t
+  {
+    size_t back = links_[Sentinel(list)].prev;
+    return back == Sentinel(list) ? NONE : static_cast<frame_id_t>(back);
+  }
+
+  auto FrameLists::Prev(frame_id_t frame_id) const -> frame_id_t
+  {
+    size_t prev = links_[frame_id].prev;
+    return prev >= num_frames_ ? NONE : static_cast<frame_id_t>(prev);
+  }
+
+  // prev 指向更靠近前端（更新）的一侧，next 指向更旧的一侧
+  void FrameLists::PushFront(int list, frame_id_t frame_id)
+  {
+    BUSTUB_ASSERT(links_[frame_id].list == -1, "frame is already in a list");
+    size_t sentinel = Sentinel(list);
+    size_t front = links_[sentinel].next;
+    links_[frame_id] = {sentinel, front, list, links_[frame_id].is_evictable};
+    links_[front].prev = frame_id;
+    links_[sentinel].next = frame_id;
+    sizes_[list]++;
+  }
+
+  void FrameLists::Unlink(frame_id_t frame_id)
+  {
+    Link &link = links_[frame_id];
+    BUSTUB_ASSERT(link.list != -1, "frame is not in a list");
+    links_[link.prev].next = link.next;
+    links_[link.next].prev = link.prev;
+    sizes_[link.list]--;
+    link.list = -1;
+  }
+
+  void FrameLists::Erase(frame_id_t frame_id)
+  {
+    Unlink(frame_id);
+    SetEvictableFlag(frame_id, false);
+  }
+
+  auto FrameLists::Remove(frame_id_t frame_id) -> bool
+  {
+    if (links_[frame_id].list == -1)
+    {
+      return false;
+    }
+    if (!links_[frame_id].is_evictable)
+    {
+      throw std::runtime_error("Cannot remove a non-evictable frame");
+    }
+    Erase(frame_id);
+    return true;
+  }
+
+  void FrameLists::MoveToFront(int list, frame_id_t frame_id)
+  {
+    if (links_[frame_id].list != -1)
+    {
+      Unlink(frame_id);
+    }
+    PushFront(list, frame_id);
+  }
+
+  void FrameLists::SetEvictable(frame_id_t frame_id, bool set_evictable)
+  {
+    if (links_[frame_id].list != -1)
+    {
+      SetEvictableFlag(frame_id, set_evictable);
+    }
+  }
+
+  // 修改可驱逐标记并维护可驱逐帧的数量
+  void FrameLists::SetEvictableFlag(frame_id_t frame_id, bool set_evictable)
+  {
+    Link &link = links_[frame_id];
+    if (link.is_evictable == set_evictable)
+    {
+      return;
+    }
+    link.is_evictable = set_evictable;
+    if (set_evictable)
+    {
+      num_evictable_++;
+    }
+    else
+    {
+      num_evictable_--;
+    }
+  }
+
+  // 从链表的 LRU 端开始找第一个可驱逐的帧
+  auto FrameLists::FindVictim(int list) const -> frame_id_t
+  {
+    frame_id_t frame_id = Back(list);
+    while (frame_id != NONE && !links_[frame_id].is_evictable)
+    {
+      frame_id = Prev(frame_id);
+    }
+    return frame_id;
+  }
+
+  void GhostList::Push(page_id_t page_id)
+  {
+    Erase(page_id); // 扫描访问不查询历史，同一页面可能再次被淘汰
+    order_.push_front(page_id);
+    index_[page_id] = order_.begin();
+  }
+
+  auto GhostList::Erase(page_id_t page_id) -> bool
+  {
+    auto it = index_.find(page_id);
+    if (it == index_.end())
+    {
+      return false;
+    }
+    order_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+  void GhostList::PopOldest()
+  {
+    BUSTUB_ASSERT(!order_.empty(), "ghost list is empty");
+    index_.erase(order_.back());
+    order_.pop_back();
+  }
+
+} // namespace bustub
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub
+{
+
+  /**
+   * A fixed set of intrusive doubly linked lists over frame ids, for the list-based replacers.
+   * Every frame is in at most one list at a time. All links are allocated up front, so moving a
+   * frame between lists never allocates. The front of a list is its most recently inserted end.
+   *
+   * The lists also keep the evictable flag of every frame in them and the number of evictable
+   * frames, which is what the replacers report as their Size. Not thread-safe; the replacer's latch
+   * protects it.
+   */
+  class FrameLists
+  {
+  public:
+    static constexpr frame_id_t NONE = -1;
+
+    FrameLists(size_t num_frames, size_t num_lists);
+
+    /** @return The list frame_id is in, or -1. */
+    auto ListOf(frame_id_t frame_id) const -> int { return links_[frame_id].list; }
+
+    auto Size(int list) const -> size_t { return sizes_[list]; }
+
+    /** @return The number of evictable frames over all lists. */
+    auto NumEvictable() const -> size_t { return num_evictable_; }
+
+    /** @brief Mark frame_id evictable or not; does nothing if it is not in a list. */
+    void SetEvictable(frame_id_t frame_id, bool set_evictable);
+
+    /** @return The oldest evictable frame of list, or NONE if it has none. */
+    auto FindVictim(int list) const -> frame_id_t;
+
+    /** @return The oldest frame of list, or NONE if it is empty. */
+    auto Back(int list) const -> frame_id_t;
+
+    /** @return The frame inserted just after frame_id in its list (towards the front), or NONE. */
+    auto Prev(frame_id_t frame_id) const -> frame_id_t;
+
+    /** @brief Insert frame_id, which must not be in any list, at the front of list. */
+    void PushFront(int list, frame_id_t frame_id);
+
+    /** @brief Unlink frame_id from its list, which clears its evictable flag; it must be in one. */
+    void Erase(frame_id_t frame_id);
+
+    /**
+     * @brief Erase frame_id for Replacer::Remove.
+     * @return False if frame_id is not in a list; throws std::runtime_error if it is not evictable.
+     */
+    auto Remove(frame_id_t frame_id) -> bool;
+
+    /**
+     * @brief Move frame_id to the front of list, unlinking it from its current list first. Its
+     * evictable flag is kept.
+     */
+    void MoveToFront(int list, frame_id_t frame_id);
+
+  private:
+    // 每个链表有一个哨兵节点，位于所有帧之后
+    struct Link
+    {
+      size_t prev;
+      size_t next;
+      int list{-1};
+      bool is_evictable{false};
+    };
+
+    auto Sentinel(int list) const -> size_t { return num_frames_ + list; }
+
+    // 从链表中摘下帧，不改变可驱逐标记
+    void Unlink(frame_id_t frame_id);
+
+    void SetEvictableFlag(frame_id_t frame_id, bool set_evictable);
+
+    size_t num_frames_;
+    std::vector<Link> links_;
+    std::vector<size_t> sizes_;
+    size_t num_evictable_{0};
+  };
+
+  /**
+   * The history of pages recently evicted from a list, oldest first out, with O(1) membership.
+   * Ghost entries remember a page id only; the page itself is no longer in the buffer pool.
+   */
+  class GhostList
+  {
+  public:
+    auto Contains(page_id_t page_id) const -> bool { return index_.count(page_id) != 0; }
+
+    auto Size() const -> size_t { return order_.size(); }
+
+    /** @brief Remember page_id as the newest entry, replacing an older entry for it. */
+    void Push(page_id_t page_id);
+
+    /** @brief Forget page_id if present. @return Whether it was present. */
+    auto Erase(page_id_t page_id) -> bool;
+
+    /** @brief Forget the oldest entry; the list must not be empty. */
+    void PopOldest();
+
+  private:
+    std::list<page_id_t> order_;  // 前端为最新的项
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+  };
+
+} // namespace bustub
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_benchmark.cpp
+//
+// Identification: tools/benchmark/hash_table_benchmark.cpp
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Google Benchmark microbenchmarks for ExtendibleHashTable, over the instantiations the buffer pool
+ * and the tests use. Arguments are {bucket size, number of keys}; the multi-threaded variants share
+ * one table between all threads.
+ *
+ *    ./hash_table_benchmark --benchmark_filter=Find
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+namespace {
+
+template <typename V>
+auto MakeValue(int64_t i) -> V {
+  if constexpr (std::is_same_v<V, std::string>) {
+    return std::to_string(i);
+  } else if constexpr (std::is_pointer_v<V>) {
+    return reinterpret_cast<V>(static_cast<uintptr_t>(i + 1) * alignof(std::max_align_t));  // 只比较，从不解引用
+  } else {
+    return static_cast<V>(i);
+  }
+}
+
+template <typename Table>
+auto SharedTable() -> std::unique_ptr<Table> & {
+  static std::unique_ptr<Table> table;
+  return table;
+}
+
+/** 单线程：每次迭代从空表开始插入 range(1) 个键，包括所有的目录扩展和桶分裂 */
+template <typename Table, typename V>
+void BM_InsertFresh(benchmark::State &state) {
+  auto bucket_size = static_cast<size_t>(state.range(0));
+  auto num_keys = static_cast<int>(state.range(1));
+  for (auto _ : state) {
+    Table table(bucket_size);
+    for (int i = 0; i < num_keys; i++) {
+      table.Insert(i, MakeValue<V>(i));
+    }
+    benchmark::DoNotOptimize(table.GetNumBuckets());
+  }
+  state.SetItemsProcessed(state.iterations() * num_keys);
+}
+
+/** 多线程：所有线程向同一个表插入互不相同的键 */
+template <typename Table, typename V>
+void BM_InsertShared(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    SharedTable<Table>() = std::make_unique<Table>(static_cast<size_t>(state.range(0)));
+  }
+  int64_t key = state.thread_index();
+  for (auto _ : state) {
+    SharedTable<Table>()->Insert(static_cast<int>(key), MakeValue<V>(key));
+    key += state.threads();
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    SharedTable<Table>().reset();
+  }
+}
+
+/** 预先插入 range(1) 个键，随机查找 [0, 2 * range(1)) 中的键，命中率约为一半 */
+template <typename Table, typename V>
+void BM_Find(benchmark::State &state) {
+  auto num_keys = static_cast<int>(state.range(1));
+  if (state.thread_index() == 0) {
+    SharedTable<Table>() = std::make_unique<Table>(static_cast<size_t>(state.range(0)));
+    for (int i = 0; i < num_keys; i++) {
+      SharedTable<Table>()->Insert(i, MakeValue<V>(i));
+    }
+  }
+  XorShift rng(state.thread_index());
+  V value;
+  int64_t hits = 0;
+  for (auto _ : state) {
+    hits += static_cast<int64_t>(
+        SharedTable<Table>()->Find(static_cast<int>(rng.Next() % (2 * static_cast<uint64_t>(num_keys))), value));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["hit_ratio"] = benchmark::Counter(static_cast<double>(hits) / static_cast<double>(state.iterations()),
+                                                   benchmark::Counter::kAvgThreads);
+  if (state.thread_index() == 0) {
+    SharedTable<Table>().reset();
+  }
+}
+
+/** 预先插入 range(1) 个键，每次迭代删除一个随机键再插回，表的大小保持不变 */
+template <typename Table, typename V>
+void BM_RemoveInsert(benchmark::State &state) {
+  auto num_keys = static_cast<int>(state.range(1));
+  if (state.thread_index() == 0) {
+    SharedTable<Table>() = std::make_unique<Table>(static_cast<size_t>(state.range(0)));
+    for (int i = 0; i < num_keys; i++) {
+      SharedTable<Table>()->Insert(i, MakeValue<V>(i));
+    }
+  }
+  XorShift rng(state.thread_index() + 1000);
+  for (auto _ : state) {
+    auto key = static_cast<int>(rng.Next() % static_cast<uint64_t>(num_keys));
+    SharedTable<Table>()->Remove(key);
+    SharedTable<Table>()->Insert(key, MakeValue<V>(key));
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+  if (state.thread_index() == 0) {
+    SharedTable<Table>().reset();
+  }
+}
+
+void TableArgs(benchmark::internal::Benchmark *b) {
+  for (int64_t bucket_size : {4, 16, 64}) {
+    for (int64_t num_keys : {1 << 10, 1 << 16, 1 << 20}) {
+      b->Args({bucket_size, num_keys});
+    }
+  }
+}
+
+void SharedArgs(benchmark::internal::Benchmark *b) {
+  for (int64_t bucket_size : {4, 16, 64}) {
+    b->Args({bucket_size, 1 << 16});
+  }
+  b->ThreadRange(1, 16)->UseRealTime();
+}
+
+using IntTable = ExtendibleHashTable<int, int>;
+using IntMixTable = ExtendibleHashTable<int, int, IntegerMixHash<int>>;
+using StringTable = ExtendibleHashTable<int, std::string>;
+using PageTable = ExtendibleHashTable<page_id_t, Page *>;
+using PageMixTable = ExtendibleHashTable<page_id_t, Page *, IntegerMixHash<page_id_t>>;
+
+BENCHMARK_TEMPLATE(BM_InsertFresh, IntTable, int)->Apply(TableArgs);
+BENCHMARK_TEMPLATE(BM_InsertFresh, IntMixTable, int)->Apply(TableArgs);
+BENCHMARK_TEMPLATE(BM_InsertFresh, StringTable, std::string)->Apply(TableArgs);
+BENCHMARK_TEMPLATE(BM_InsertFresh, PageTable, Page *)->Apply(TableArgs);
+BENCHMARK_TEMPLATE(BM_InsertFresh, PageMixTable, Page *)->Apply(TableArgs);
+
+BENCHMARK_TEMPLATE(BM_InsertShared, IntTable, int)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_InsertShared, StringTable, std::string)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_InsertShared, PageTable, Page *)->Apply(SharedArgs);
+
+BENCHMARK_TEMPLATE(BM_Find, IntTable, int)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_Find, IntMixTable, int)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_Find, StringTable, std::string)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_Find, PageTable, Page *)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_Find, PageMixTable, Page *)->Apply(SharedArgs);
+
+BENCHMARK_TEMPLATE(BM_RemoveInsert, IntTable, int)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_RemoveInsert, StringTable, std::string)->Apply(SharedArgs);
+BENCHMARK_TEMPLATE(BM_RemoveInsert, PageTable, Page *)->Apply(SharedArgs);
+
+}  // namespace
+}  // namespace bustub
+
+BENCHMARK_MAIN();
@@ -1,105 +1,391 @@
 #include "buffer/lru_k_replacer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread> // NOLINT
+#include <utility>
+
 namespace bustub
 {
 
-  LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+  LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k, size_t correlated_period,
+                             const MemoryPolicy &memory_policy)
+      : replacer_size_(num_frames),
+        k_(k),
+        correlated_period_(correlated_period),
+        frames_(num_frames, PolicyAllocator<FrameInfo>(memory_policy)),
+        access_times_(num_frames * k, PolicyAllocator<RelativeTimestamp>(memory_policy)),
+        evict_heap_(PolicyAllocator<frame_id_t>(memory_policy)),
+        stripes_(ACCESS_STRIPES)
+  {
+    BUSTUB_ASSERT(num_frames < INVALID_HEAP_POS && k < std::numeric_limits<uint32_t>::max(),
+                  "Too many frames or too large k!");
+    evict_heap_.reserve(num_frames);
+    drained_.reserve(ACCESS_STRIPES * ACCESS_BUFFER_SIZE);
+    for (AccessStripe &stripe : stripes_)
+    {
+      for (size_t i = 0; i < ACCESS_BUFFER_SIZE; i++)
+      {
+        stripe.slots[i].seq.store(i, std::memory_order_relaxed);
+      }
+    }
+  }
 
   /*Evict淘汰帧：选择具有最大后退k-距离的帧进行淘汰
-   遍历所有可淘汰的帧，计算其“后退k-距离”。
    后退k-距离是当前时间戳与第k次历史访问之间的差异。
    如果一个帧的历史访问次数小于k，则认为其后退k-距离为正无穷。
    如果有多个帧具有相同的最大后退k-距离，则选择时间戳最早的帧。
+   可驱逐帧按上述顺序保存在 evict_heap_ 中，堆顶即为驱逐对象，无需遍历所有帧。
+   选择前先应用所有缓冲的访问。回调在释放锁之后调用。
   */
   auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool
   {
-    std::scoped_lock<std::mutex> lock(latch_);//加互斥锁
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_); //加互斥锁
+    DrainAccesses();
+    bool dirty;
+    if (!EvictInternal(frame_id, &dirty))
+    {
+      return false;
+    }
+    lock.unlock();
+    if (eviction_callback_)
+    {
+      eviction_callback_(*frame_id, dirty);
+    }
+    return true;
+  }
+
+  // EvictBatch：一次加锁、一次应用缓冲的访问，连续弹出堆顶，每个帧的代价为一次堆删除
+  auto LRUKReplacer::EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t
+  {
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    DrainAccesses();
+    size_t evicted = 0;
+    std::vector<bool> dirty;
+    bool victim_dirty;
+    while (evicted < n && EvictInternal(&frame_ids[evicted], &victim_dirty))
+    {
+      evicted++;
+      if (eviction_callback_)
+      {
+        dirty.push_back(victim_dirty);
+      }
+    }
+    lock.unlock();
+    if (eviction_callback_)
+    {
+      for (size_t i = 0; i < evicted; i++)
+      {
+        eviction_callback_(frame_ids[i], dirty[i]);
+      }
+    }
+    return evicted;
+  }
+
+  /*VisitVictims按驱逐顺序访问堆中的帧
+   堆中前n小的元素都在堆顶附近：从堆顶开始，每取出一个位置就把它的两个子节点加入候选集合，
+   候选集合中最先被驱逐的就是下一个结果，访问n个帧的代价为 O(n log n)，与可驱逐帧的总数无关。
+  */
+  template <typename Visit>
+  void LRUKReplacer::VisitVictims(Visit &&visit) const
+  {
+    if (evict_heap_.empty())
+    {
+      return;
+    }
+    // 候选集合是以堆中位置为元素的小顶堆，std::push_heap 需要"小于"的反向比较
+    auto later = [this](size_t a, size_t b) { return EvictsBefore(evict_heap_[b], evict_heap_[a]); };
+    std::vector<size_t> candidates{0};
+    while (!candidates.empty())
+    {
+      std::pop_heap(candidates.begin(), candidates.end(), later);
+      size_t pos = candidates.back();
+      candidates.pop_back();
+      if (!visit(pos))
+      {
+        return;
+      }
+      for (size_t child = 2 * pos + 1; child <= 2 * pos + 2 && child < evict_heap_.size(); child++)
+      {
+        candidates.push_back(child);
+        std::push_heap(candidates.begin(), candidates.end(), later);
+      }
+    }
+  }
+
+  auto LRUKReplacer::PeekVictims(size_t n) -> std::vector<frame_id_t>
+  {
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    DrainAccesses();
+    std::vector<frame_id_t> victims;
+    victims.reserve(std::min(n, evict_heap_.size()));
+    if (n > 0)
+    {
+      VisitVictims([&](size_t pos) {
+        victims.push_back(evict_heap_[pos]);
+        return victims.size() < n;
+      });
+    }
+    return victims;
+  }
+
+  /*ChooseVictim选择驱逐对象
+   堆顶是干净的或没有设置容忍度时直接返回堆顶。
+   否则按驱逐顺序查看与堆顶同一层、最旧时间戳不晚于堆顶加容忍度的帧，返回其中第一个干净的帧；
+   驱逐顺序中后面的帧的键只会更大，遇到超出范围的帧即可停止。
+  */
+  auto LRUKReplacer::ChooseVictim() const -> size_t
+  {
+    const FrameInfo &best = frames_[evict_heap_.front()];
+    if (dirty_tolerance_ == 0 || !best.dirty)
+    {
+      return 0;
+    }
+    bool best_full = best.access_count >= k_;
+    size_t bound = size_t{best.oldest} + dirty_tolerance_;
+    size_t visited = 0;
+    size_t victim = 0;
+    VisitVictims([&](size_t pos) {
+      const FrameInfo &frame = frames_[evict_heap_[pos]];
+      if (frame.scan_only != best.scan_only || (frame.access_count >= k_) != best_full || frame.oldest > bound)
+      {
+        return false;
+      }
+      if (!frame.dirty)
+      {
+        victim = pos;
+        return false;
+      }
+      return ++visited < MAX_DIRTY_CANDIDATES;
+    });
+    return victim;
+  }
+
+  auto LRUKReplacer::EvictInternal(frame_id_t *frame_id, bool *dirty) -> bool
+  {
     // 如果没有可驱逐的页面，返回false
     if (curr_size_ == 0)
     {
+        stats_.failed_evicts_.Add();
         return false;
     }
-    // 优先从历史访问列表中驱逐
-    for (auto it = history_list_.begin(); it != history_list_.end(); ++it)
+    size_t pos = ChooseVictim();
+    if (pos != 0)
     {
-      AccessHistory &history = frame_data_[*it]; // 获取页面的访问历史
-      if (history.is_evictable)
-      { // 判断该页面是否可驱逐
-        *frame_id = *it;
-        Remove(*frame_id); // 从存储中移除该页面
-        return true;
-      }
+      stats_.dirty_skips_.Add();
     }
+    *frame_id = evict_heap_[pos];
+    const FrameInfo &victim = frames_[*frame_id];
+    *dirty = victim.dirty;
+    if (victim.scan_only)
+    {
+      stats_.evictions_scan_.Add();
+    }
+    else if (victim.access_count < k_)
+    {
+      stats_.evictions_history_.Add();
+    }
+    else
+    {
+      stats_.evictions_cache_.Add();
+    }
+    size_t heap_steps = heap_steps_;
+    RemoveInternal(*frame_id); // 从存储中移除该页面
+    stats_.evict_heap_steps_.Add(heap_steps_ - heap_steps);
+    return true;
+  }
 
-    // 如果历史访问列表中没有可驱逐的页面，从缓存列表中寻找
-    frame_id_t evict_frame = -1;
-    size_t max_time_diff = 0;
+  /*RecordAccess记录帧访问
+   只分配时间戳并把访问写入当前线程对应的缓冲区，不加锁。
+   缓冲区已满时加锁，先应用所有缓冲的访问，再直接应用这次访问。
+  */
+  void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type,
+                                  [[maybe_unused]] page_id_t page_id)
+  {
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    Access access{frame_id, access_type, current_timestamp_.fetch_add(1, std::memory_order_relaxed) + 1};
+    if (TryBuffer(access))
+    {
+      return;
+    }
+    stats_.buffer_full_.Add();
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    DrainAccesses();
+    ApplyAccess(access);
+  }
 
-    for (auto it = cache_list_.begin(); it != cache_list_.end(); ++it)
+  /*ApplyAccess应用一次访问：更新帧的访问历史
+   把访问的时间戳写入该帧的环形缓冲区中。
+   扫描访问只在扫描层内生效：新帧进入扫描层，扫描层的帧只刷新唯一的时间戳，其余帧忽略扫描访问。
+   距上一次访问不超过 correlated_period_ 的访问是相关访问，只更新 last_access，不计入历史。
+   下一次不相关的访问到来时，按 LRU-K 论文把这段相关访问的长度加到所有历史时间戳上，
+   使 k-距离从这段突发访问结束时算起。
+   新的访问只会让帧的驱逐键变大，因此可驱逐帧只需在堆中下沉。
+  */
+  void LRUKReplacer::ApplyAccess(const Access &access)
+  {
+    if (access.timestamp - epoch_ > MAX_RELATIVE_TIMESTAMP)
     {
-      AccessHistory &history = frame_data_[*it]; // 获取页面的访问历史
-      if (!history.is_evictable)
+      Rebase(access.timestamp);
+    }
+    frame_id_t frame_id = access.frame_id;
+    FrameInfo &frame = frames_[frame_id]; // 获取该页面的状态
+    RelativeTimestamp *times = &access_times_[frame_id * k_];
+    // 并发的访问可能晚于同一帧时间戳更大的访问才被应用，此时把它视为紧接在后者之后
+    auto timestamp = static_cast<RelativeTimestamp>(
+        std::max<size_t>(access.timestamp - epoch_, size_t{frame.last_access} + 1));
+    if (access.access_type == AccessType::Scan)
+    {
+      if (frame.access_count == 0)
       {
-        continue;
+        frame.scan_only = true;
+        frame.access_count = 1;
       }
-      const auto &access_history = history.access_times;
-      auto access_it = access_history.begin();
-      std::advance(access_it, access_history.size() - k_); // 获取倒数第k次的访问时间
-      size_t time_diff = current_timestamp_ - *access_it;  // 计算当前时间与上次访问的时间差
-
-      // 选择时间差最大的页面作为驱逐目标
-      if (evict_frame == -1 || time_diff > max_time_diff)
+      else if (!frame.scan_only)
       {
-        evict_frame = *it;
-        max_time_diff = time_diff;
+        return; // 扫描不影响工作集中的帧
       }
+      times[0] = timestamp;
+      frame.oldest = timestamp;
+      frame.last_access = timestamp;
     }
-
-    if (evict_frame != -1)
+    else
     {
-      *frame_id = evict_frame; // 返回驱逐的页面
-      Remove(evict_frame);     // 从存储中移除该页面
-      return true;
+      bool was_scan_only = frame.scan_only;
+      frame.scan_only = false; // 离开扫描层，之前的扫描访问算作第一次访问
+      if (!was_scan_only && frame.access_count > 0)
+      {
+        if (timestamp - frame.last_access <= correlated_period_)
+        {
+          frame.last_access = timestamp;
+          return; // 相关访问，与上一次访问算作同一次
+        }
+        ShiftCorrelatedPeriod(frame, times);
+      }
+      frame.last_access = timestamp;
+      if (frame.access_count < k_)
+      {
+        times[frame.access_count++] = timestamp; // 记录访问时间
+      }
+      else
+      {
+        // 已有k次访问，覆盖最旧的时间戳
+        times[frame.head] = timestamp;
+        frame.head = (frame.head + 1) % k_;
+      }
+      frame.oldest = times[frame.head];
     }
 
-    return false; // 如果没有可驱逐的页面，返回false
+    if (frame.is_evictable)
+    {
+      HeapSiftDown(frame.heap_pos);
+    }
   }
 
-  /*RecordAccess记录帧访问：更新帧的访问历史
-   记录给定帧ID的访问时间戳。
-   每次访问都会增加当前时间戳，并将其加入到该帧的访问历史中。
+  /*把最近一段相关访问的长度（last_access 减去最新的历史时间戳）加到所有历史时间戳上
+   即论文中的 HIST(i) = HIST(i-1) + correl_period：最新的时间戳因此移到这段相关访问的末尾 last_access，
+   更早的时间戳随之前移，k-距离从相关访问结束时算起。
   */
-  void LRUKReplacer::RecordAccess(frame_id_t frame_id)
+  void LRUKReplacer::ShiftCorrelatedPeriod(const FrameInfo &frame, RelativeTimestamp *times) const
   {
-    std::scoped_lock<std::mutex> lock(latch_);
-    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
-    current_timestamp_++; // 更新时间戳
-    // 处理新访问的页面，如果该页面没有记录
-    auto &history = frame_data_[frame_id]; // 获取该页面的访问历史
-    if (history.access_times.empty())
+    size_t newest = frame.access_count < k_ ? frame.access_count - 1 : (frame.head + k_ - 1) % k_;
+    RelativeTimestamp period = frame.last_access - times[newest];
+    if (period == 0)
     {
-      history.access_times.push_back(current_timestamp_); // 记录访问时间
-      history_list_.push_back(frame_id);                  // 将页面添加到历史访问列表
       return;
     }
+    for (size_t i = 0; i < frame.access_count; i++)
+    {
+      times[i] += period;
+    }
+  }
 
-    // 更新页面的访问历史
-    history.access_times.push_back(current_timestamp_);
+  /*Rebase前移相对时间戳的零点
+   让 timestamp 之前的 REBASE_KEEP 个时间戳保持精确，所有被跟踪帧的时间戳减去同一个差值，
+   更早的时间戳截断为0。每 2^30 次以上的访问才发生一次，均摊代价可以忽略。
+  */
+  void LRUKReplacer::Rebase(size_t timestamp)
+  {
+    auto delta = static_cast<RelativeTimestamp>(timestamp - epoch_ - REBASE_KEEP);
+    auto shift = [delta](RelativeTimestamp t) -> RelativeTimestamp { return t > delta ? t - delta : 0; };
+    for (size_t i = 0; i < frames_.size(); i++)
+    {
+      FrameInfo &frame = frames_[i];
+      if (frame.access_count == 0)
+      {
+        continue;
+      }
+      RelativeTimestamp *times = &access_times_[i * k_];
+      for (size_t j = 0; j < frame.access_count; j++)
+      {
+        times[j] = shift(times[j]);
+      }
+      frame.oldest = shift(frame.oldest);
+      frame.last_access = shift(frame.last_access);
+    }
+    epoch_ += delta;
+  }
 
-    // 判断是否已达到k次访问，若达到则转移到缓存列表
-    if (history.access_times.size() == k_)
+  // TryBuffer：在线程对应的环形缓冲区中占一个槽位并写入访问（Vyukov 有界队列的生产者一侧）
+  auto LRUKReplacer::TryBuffer(const Access &access) -> bool
+  {
+    thread_local const size_t stripe_index =
+        std::hash<std::thread::id>{}(std::this_thread::get_id()) % ACCESS_STRIPES;
+    AccessStripe &stripe = stripes_[stripe_index];
+    size_t pos = stripe.tail.load(std::memory_order_relaxed);
+    while (true)
     {
-      history_list_.remove(frame_id);  // 从历史列表中移除
-      cache_list_.push_back(frame_id); // 加入到缓存列表
+      AccessSlot &slot = stripe.slots[pos & (ACCESS_BUFFER_SIZE - 1)];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (stripe.tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          slot.access = access;
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false; // 槽位中还有上一圈未取出的访问，缓冲区已满
+      }
+      else
+      {
+        pos = stripe.tail.load(std::memory_order_relaxed); // 其他生产者已占用该位置
+      }
     }
-    else if (history.access_times.size() > k_)
+  }
+
+  /*DrainAccesses取出所有缓冲区中已写完的访问，按时间戳顺序应用
+   生产者尚未写完的槽位及其之后的访问留到下一次再取，它们与本次调用是并发的。
+  */
+  void LRUKReplacer::DrainAccesses()
+  {
+    drained_.clear();
+    for (AccessStripe &stripe : stripes_)
     {
-      // 如果访问次数超过k次，维护访问历史大小
-      if (history.access_times.size() > k_ + 1)
+      while (true)
       {
-        history.access_times.pop_front(); // 保证历史记录不会超过k+1
+        AccessSlot &slot = stripe.slots[stripe.head & (ACCESS_BUFFER_SIZE - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != stripe.head + 1)
+        {
+          break;
+        }
+        drained_.push_back(slot.access);
+        slot.seq.store(stripe.head + ACCESS_BUFFER_SIZE, std::memory_order_release);
+        stripe.head++;
       }
     }
+    std::sort(drained_.begin(), drained_.end(),
+              [](const Access &a, const Access &b) { return a.timestamp < b.timestamp; });
+    for (const Access &access : drained_)
+    {
+      ApplyAccess(access);
+    }
   }
 
   /*SetEvictable设置帧的可淘汰状态
@@ -108,71 +394,218 @@ namespace bustub
   */
   void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable)
   {
-    std::scoped_lock<std::mutex> lock(latch_);
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
     BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
 
-    auto it = frame_data_.find(frame_id);//查找frame_id
-    if (it == frame_data_.end())
+    FrameInfo &frame = frames_[frame_id];
+    if (frame.access_count == 0)
+    {
+      DrainAccesses(); // 帧的第一次访问可能还在缓冲区中
+    }
+    if (frame.access_count == 0)
     {
       return; // 如果页面不存在，直接返回
     }
 
-    AccessHistory &history = it->second; // 获取页面的访问历史
-    if (history.is_evictable == set_evictable)
+    if (frame.is_evictable == set_evictable)
     {
       return; // 如果页面的可驱逐状态没有改变，直接返回
     }
 
-    history.is_evictable = set_evictable; // 更新页面的可驱逐状态
+    frame.is_evictable = set_evictable; // 更新页面的可驱逐状态
     if (set_evictable)
     {
+      HeapPush(frame_id); // 加入驱逐堆
       curr_size_++; // 增加当前缓存中的页面数
     }
     else
     {
+      HeapErase(frame_id); // 从驱逐堆中移除
       curr_size_--; // 减少当前缓存中的页面数
     }
   }
 
+  /*SetDirty设置帧是否为脏页
+   脏页标记不是堆的键，设置后不需要调整堆。
+  */
+  void LRUKReplacer::SetDirty(frame_id_t frame_id, bool dirty)
+  {
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    FrameInfo &frame = frames_[frame_id];
+    if (frame.access_count == 0)
+    {
+      DrainAccesses(); // 帧的第一次访问可能还在缓冲区中
+    }
+    if (frame.access_count > 0)
+    {
+      frame.dirty = dirty;
+    }
+  }
+
+  void LRUKReplacer::SetDirtyTolerance(size_t tolerance)
+  {
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    dirty_tolerance_ = tolerance;
+  }
+
+  void LRUKReplacer::SetEvictionCallback(EvictionCallback callback)
+  {
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    eviction_callback_ = std::move(callback);
+  }
+
   /*Remove移除指定帧
    清除该帧的访问历史,
    并且标记该帧为不可淘汰，减少替换器大小。
   */
   void LRUKReplacer::Remove(frame_id_t frame_id)
   {
-    // 调用Remove时已经加了锁，不需要重复加锁
-    auto it = frame_data_.find(frame_id);
-    if (it == frame_data_.end())
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
+    DrainAccesses(); // 缓冲的访问不能在移除之后才被应用
+    RemoveInternal(frame_id);
+  }
+
+  void LRUKReplacer::RemoveInternal(frame_id_t frame_id)
+  {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_ || frames_[frame_id].access_count == 0)
     {
       return; // 未找到页面，直接返回
     }
 
-    AccessHistory &history = it->second; // 获取页面的访问历史
-    if (!history.is_evictable)
+    FrameInfo &frame = frames_[frame_id];
+    if (!frame.is_evictable)
     {
       throw std::runtime_error("Cannot remove a non-evictable frame"); // 如果页面不可驱逐，抛出异常
     }
 
-    // 从相应的列表中移除页面
-    if (history.access_times.size() < k_)
-    {
-      history_list_.remove(frame_id); // 从历史访问列表中移除
-    }
-    else
-    {
-      cache_list_.remove(frame_id); // 从缓存列表中移除
-    }
-    // 从存储中删除该页面
-    frame_data_.erase(frame_id);
+    // 从驱逐堆中移除页面
+    HeapErase(frame_id);
+    // 清空该页面的状态，环形缓冲区中的旧时间戳会在下次访问时被覆盖
+    frame = FrameInfo{};
     // 更新当前缓存中的页面数
     curr_size_--;
   }
 
+  auto LRUKReplacer::GetStats() const -> Stats
+  {
+    return {stats_.evictions_scan_.Load(),   stats_.evictions_history_.Load(), stats_.evictions_cache_.Load(),
+            stats_.failed_evicts_.Load(),    stats_.evict_heap_steps_.Load(),  stats_.buffer_full_.Load(),
+            stats_.dirty_skips_.Load(),      stats_.latch_.contended_.Load(),  stats_.latch_.wait_ns_.Load()};
+  }
+
+  auto LRUKReplacer::Stats::operator+=(const Stats &other) -> Stats &
+  {
+    evictions_scan += other.evictions_scan;
+    evictions_history += other.evictions_history;
+    evictions_cache += other.evictions_cache;
+    failed_evicts += other.failed_evicts;
+    evict_heap_steps += other.evict_heap_steps;
+    buffer_full += other.buffer_full;
+    dirty_skips += other.dirty_skips;
+    latch_contended += other.latch_contended;
+    latch_wait_ns += other.latch_wait_ns;
+    return *this;
+  }
+
   // Size:返回当前可淘汰帧的数量。
   auto LRUKReplacer::Size() -> size_t
   {
-    std::scoped_lock<std::mutex> lock(latch_);
+    auto lock = AcquireLatch<std::unique_lock<std::mutex>>(latch_, stats_.latch_);
     return curr_size_; // 返回当前缓存中的页面数量
   }
 
+  // ========================== 驱逐堆 ==========================
+
+  // 扫描层的帧优先，其次是访问不足k次的帧；同类帧中最旧时间戳更早的优先。
+  auto LRUKReplacer::EvictsBefore(frame_id_t a, frame_id_t b) const -> bool
+  {
+    if (frames_[a].scan_only != frames_[b].scan_only)
+    {
+      return frames_[a].scan_only;
+    }
+    bool a_full = frames_[a].access_count >= k_;
+    bool b_full = frames_[b].access_count >= k_;
+    if (a_full != b_full)
+    {
+      return !a_full;
+    }
+    return frames_[a].oldest < frames_[b].oldest;
+  }
+
+  void LRUKReplacer::HeapPush(frame_id_t frame_id)
+  {
+    frames_[frame_id].heap_pos = static_cast<uint32_t>(evict_heap_.size());
+    evict_heap_.push_back(frame_id); // 容量在构造时已预留，不会重新分配
+    HeapSiftUp(evict_heap_.size() - 1);
+  }
+
+  void LRUKReplacer::HeapErase(frame_id_t frame_id)
+  {
+    size_t pos = frames_[frame_id].heap_pos;
+    size_t last = evict_heap_.size() - 1;
+    if (pos != last)
+    {
+      HeapSwap(pos, last);
+    }
+    evict_heap_.pop_back();
+    frames_[frame_id].heap_pos = INVALID_HEAP_POS;
+    if (pos < evict_heap_.size())
+    {
+      // 换上来的帧可能需要上浮或下沉
+      HeapSiftUp(pos);
+      HeapSiftDown(frames_[evict_heap_[pos]].heap_pos);
+    }
+  }
+
+  void LRUKReplacer::HeapSiftUp(size_t pos)
+  {
+    while (pos > 0)
+    {
+      size_t parent = (pos - 1) / 2;
+      if (!EvictsBefore(evict_heap_[pos], evict_heap_[parent]))
+      {
+        break;
+      }
+      HeapSwap(pos, parent);
+      pos = parent;
+    }
+  }
+
+  void LRUKReplacer::HeapSiftDown(size_t pos)
+  {
+    size_t size = evict_heap_.size();
+    while (true)
+    {
+      size_t best = pos;
+      size_t left = 2 * pos + 1;
+      size_t right = left + 1;
+      if (left < size && EvictsBefore(evict_heap_[left], evict_heap_[best]))
+      {
+        best = left;
+      }
+      if (right < size && EvictsBefore(evict_heap_[right], evict_heap_[best]))
+      {
+        best = right;
+      }
+      if (best == pos)
+      {
+        break;
+      }
+      HeapSwap(pos, best);
+      pos = best;
+    }
+  }
+
+  void LRUKReplacer::HeapSwap(size_t a, size_t b)
+  {
+    if constexpr (STATS_ENABLED)
+    {
+      heap_steps_++;
+    }
+    std::swap(evict_heap_[a], evict_heap_[b]);
+    frames_[evict_heap_[a]].heap_pos = static_cast<uint32_t>(a);
+    frames_[evict_heap_[b]].heap_pos = static_cast<uint32_t>(b);
+  }
+
 } // namespace bustub
@@ -1,62 +1,250 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <limits>
-#include <list>
 #include <mutex> // NOLINT
-#include <unordered_map>
 #include <vector>
 #include <deque>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/macros.h"
+#include "common/memory_policy.h"
+#include "common/stats.h"
 
 namespace bustub
 {
 
   /**
    * LRUKReplacer implements the LRU-k replacement policy.
+   *
+   * Frames only ever touched by AccessType::Scan form a separate scan tier that is evicted before
+   * any other frame, oldest first, so a large scan recycles its own frames instead of pushing out
+   * frames with fewer than k accesses or promoted ones.
+   *
+   * RecordAccess does not take the latch. Accesses are timestamped and appended to one of
+   * ACCESS_STRIPES lock-free ring buffers, picked per thread, and applied in timestamp order under
+   * the latch by the next Evict or Remove, by SetEvictable on a frame whose first access is still
+   * buffered, or by the RecordAccess that finds its ring full (as in BP-Wrapper). An access whose
+   * producer is still writing it is left for a later drain; if a newer access to the same frame is
+   * applied first, the late one is re-timed to just after it instead of keeping its own timestamp.
    */
-  class LRUKReplacer
+  class LRUKReplacer : public Replacer
   {
   public:
-    explicit LRUKReplacer(size_t num_frames, size_t k);
+    /**
+     * @param num_frames The number of frames the replacer tracks.
+     * @param k The number of accesses the backward k-distance is measured over.
+     * @param correlated_period The correlated reference period of the LRU-K paper, in timestamps
+     * (one per RecordAccess). An access to a frame within this many timestamps of its previous
+     * access is correlated with it and counts as the same reference, so a burst of pins by one
+     * operation does not look like k independent uses. 0 disables it.
+     * @param memory_policy How the per-frame arrays and the eviction heap are backed, e.g. with huge
+     * pages or on the NUMA node of the buffer pool that owns the frames.
+     */
+    explicit LRUKReplacer(size_t num_frames, size_t k, size_t correlated_period = 0,
+                          const MemoryPolicy &memory_policy = MemoryPolicy());
 
     DISALLOW_COPY_AND_MOVE(LRUKReplacer);
 
-    ~LRUKReplacer() = default;
+    ~LRUKReplacer() override = default;
+
+    auto Evict(frame_id_t *frame_id) -> bool override;
+
+    /** @brief Evict up to n frames under a single latch acquisition; see Replacer::EvictBatch. */
+    auto EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t override;
+
+    /**
+     * @brief The next n victims, best first, without evicting them, so a background writer can
+     * start flushing dirty victims before it evicts them. The answer is only a snapshot: later
+     * accesses, SetEvictable or Remove calls may reorder or drop the frames it names.
+     * @return At most n frames, fewer if there are fewer evictable frames.
+     */
+    auto PeekVictims(size_t n) -> std::vector<frame_id_t>;
+
+    /**
+     * @brief Record an access to frame_id at the current timestamp. Lock-free unless the calling
+     * thread's ring buffer is full.
+     *
+     * A Scan access to a frame that is not tracked yet puts it in the scan tier; further Scan
+     * accesses keep it there and never count towards k. Any other access takes the frame out of
+     * the scan tier. A Scan access to a frame outside the scan tier is ignored, so a scan passing
+     * over a hot page neither promotes nor refreshes it.
+     */
+    void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                      page_id_t page_id = INVALID_PAGE_ID) override;
+
+    void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+    /**
+     * @brief Mark whether the page in a tracked frame is dirty. The flag never changes the eviction
+     * order by itself; see SetDirtyTolerance. Eviction and Remove clear it.
+     */
+    void SetDirty(frame_id_t frame_id, bool dirty) override;
+
+    /**
+     * @brief Let Evict pass over a dirty best victim, so the caller does not have to write it back
+     * synchronously. Evict then takes the best clean frame of the same tier (scan tier, fewer than
+     * k accesses, k accesses) whose oldest timestamp is at most tolerance timestamps later than the
+     * best victim's, looking at no more than MAX_DIRTY_CANDIDATES frames; if there is none it evicts
+     * the dirty frame. 0, the default, evicts in strict LRU-K order. PeekVictims ignores it.
+     */
+    void SetDirtyTolerance(size_t tolerance);
+
+    using EvictionCallback = std::function<void(frame_id_t frame_id, bool dirty)>;
+
+    /**
+     * @brief Call callback with every frame Evict or EvictBatch evicts, and whether it was dirty.
+     * The callback runs after the latch is released, so it may call back into the replacer; it is
+     * not called for Remove. Set it before the replacer is shared between threads.
+     */
+    void SetEvictionCallback(EvictionCallback callback);
+
+    /** The most frames Evict looks at for a clean victim when the best one is dirty. */
+    static constexpr size_t MAX_DIRTY_CANDIDATES = 64;
+
+    void Remove(frame_id_t frame_id) override;
+
+    auto Size() -> size_t override;
+
+    /** A snapshot of the replacer's counters; see GetStats. */
+    struct Stats
+    {
+      uint64_t evictions_scan;     // Victims from the scan tier
+      uint64_t evictions_history;  // Victims with fewer than k accesses (infinite k-distance)
+      uint64_t evictions_cache;    // Victims with k accesses
+      uint64_t failed_evicts;      // Evicts that found no evictable frame
+      uint64_t evict_heap_steps;   // Heap levels sifted by Evict; divide by evictions for the per-Evict cost
+      uint64_t buffer_full;        // RecordAccess calls that found their ring full and drained in place
+      uint64_t dirty_skips;        // Evicts that passed over a dirty best victim for a clean one
+      uint64_t latch_contended;    // Latch acquisitions that had to wait
+      uint64_t latch_wait_ns;      // Total time spent waiting for the latch
+
+      auto operator+=(const Stats &other) -> Stats &;
+    };
 
-    auto Evict(frame_id_t *frame_id) -> bool;
+    /**
+     * @brief Aggregate the counters, which are only maintained when BUSTUB_ENABLE_STATS is defined
+     * and read as 0 otherwise.
+     */
+    auto GetStats() const -> Stats;
 
-    void RecordAccess(frame_id_t frame_id);
+  private:
+    std::atomic<size_t> current_timestamp_{0}; // 时间戳，记录访问时无锁递增；size_t 在64位平台上不会回绕
+    size_t curr_size_{0};                      // 可驱逐的帧数量
+    size_t replacer_size_;                     // 总帧数限制
+    size_t k_;
+    size_t correlated_period_;                 // 相关访问周期，0表示不合并相关访问
+    std::mutex latch_;
 
-    void SetEvictable(frame_id_t frame_id, bool set_evictable);
+    // frames_：按 frame_id 下标存储每个帧的状态，构造时一次性分配，访问路径上不再申请内存。
+    // access_times_：每个帧占用其中连续的k个位置，作为最近k次访问时间的环形缓冲区。
+    // evict_heap_：可驱逐帧组成的小顶堆，帧在堆中的位置记录在 FrameInfo::heap_pos 中（侵入式索引）。
+    // 堆的键为（是否不在扫描层，访问次数是否达到k次，环形缓冲区中最旧的时间戳）：
+    //   只被扫描访问过的帧最先被驱逐，按最近一次扫描访问的时间排序；
+    //   访问不足k次的帧后退k-距离为正无穷，排在前面，按首次访问时间排序；
+    //   其余帧按倒数第k次访问时间排序。堆顶即为下一个驱逐对象。
+    //
+    // 保存的时间戳都是相对于 epoch_ 的32位值。相对时间戳超过 MAX_RELATIVE_TIMESTAMP 时 Rebase
+    // 把 epoch_ 前移到只保留最近 REBASE_KEEP 个时间戳，所有保存的时间戳减去同一个差值，
+    // 更早的时间戳变为0。这个变换是单调的，堆不需要调整；代价是超过 REBASE_KEEP 次访问
+    // 之前的时间戳不再互相区分。
+
+    using RelativeTimestamp = uint32_t;
+    static constexpr size_t MAX_RELATIVE_TIMESTAMP = (size_t{1} << 31) + (size_t{1} << 30);
+    static constexpr size_t REBASE_KEEP = size_t{1} << 30;
+    static constexpr uint32_t INVALID_HEAP_POS = std::numeric_limits<uint32_t>::max();
+
+    struct FrameInfo
+    {
+      uint32_t access_count{0};              // 已记录的访问次数，最多为k，0表示未被跟踪
+      uint32_t head{0};                      // 环形缓冲区中最旧时间戳的位置
+      uint32_t heap_pos{INVALID_HEAP_POS};   // 在 evict_heap_ 中的位置
+      RelativeTimestamp oldest{0};           // 环形缓冲区中最旧的时间戳，堆比较时不必访问 access_times_
+      RelativeTimestamp last_access{0};      // 最近一次访问（包括相关访问）的时间戳
+      bool is_evictable{false};
+      bool scan_only{false};                 // 只被扫描访问过，属于扫描层
+      bool dirty{false};                     // 页面是脏的，驱逐前需要写回
+    };
 
-    void Remove(frame_id_t frame_id);
+    // 堆的比较函数：a 是否应当先于 b 被驱逐（扫描层最先，其次是访问不足k次的帧）
+    auto EvictsBefore(frame_id_t a, frame_id_t b) const -> bool;
 
-    auto Size() -> size_t;
+    // 按驱逐顺序访问堆中的帧（传入堆中的位置），visit 返回 false 时停止，不修改堆
+    template <typename Visit>
+    void VisitVictims(Visit &&visit) const;
+    // 选择驱逐对象在堆中的位置，evict_heap_ 不能为空
+    auto ChooseVictim() const -> size_t;
 
-  private:
-    [[maybe_unused]] size_t current_timestamp_{0}; // 时间戳
-    [[maybe_unused]] size_t curr_size_{0};         // 可驱逐的帧数量
-    [[maybe_unused]] size_t replacer_size_;        // 总帧数限制
-    [[maybe_unused]] size_t k_;
-    std::mutex latch_;
+    void HeapPush(frame_id_t frame_id);
+    void HeapErase(frame_id_t frame_id);
+    void HeapSiftUp(size_t pos);
+    void HeapSiftDown(size_t pos);
+    void HeapSwap(size_t a, size_t b);
 
-    // frame_data_：表示存储每个页面的相关数据，包括访问历史和是否可驱逐状态。
-    // evict_frame：表示被驱逐的页面。
-    // max_time_diff：表示最大时间差。
-    // access_history：表示访问历史。
+    // 访问缓冲区：RecordAccess 把访问写入线程对应的环形缓冲区（有界多生产者队列，
+    // 每个槽位的序号表示它当前可写还是可读），持有 latch_ 时统一取出并按时间戳顺序应用。
+    static constexpr size_t ACCESS_STRIPES = 16;
+    static constexpr size_t ACCESS_BUFFER_SIZE = 128; // 必须是2的幂
 
-    struct AccessHistory
+    struct Access
     {
-      std::list<size_t> access_times;
-      bool is_evictable{false};
+      frame_id_t frame_id;
+      AccessType access_type;
+      size_t timestamp;
+    };
+
+    struct AccessSlot
+    {
+      std::atomic<size_t> seq; // 等于写入位置时可写，等于写入位置加一时可读
+      Access access;
     };
 
-    std::unordered_map<frame_id_t, AccessHistory> frame_data_;
+    struct alignas(64) AccessStripe
+    {
+      std::atomic<size_t> tail{0}; // 下一个写入位置，由生产者争用
+      size_t head{0};              // 下一个读取位置，只在持有 latch_ 时访问
+      std::array<AccessSlot, ACCESS_BUFFER_SIZE> slots;
+    };
 
-    std::list<frame_id_t> history_list_;
-    std::list<frame_id_t> cache_list_;
+    // 把访问写入缓冲区，缓冲区已满时返回 false
+    auto TryBuffer(const Access &access) -> bool;
+    // 调用前必须已持有 latch_
+    void DrainAccesses();
+    void ApplyAccess(const Access &access);
+
+    // 调用前必须已持有 latch_
+    auto EvictInternal(frame_id_t *frame_id, bool *dirty) -> bool;
+    void RemoveInternal(frame_id_t frame_id);
+    void ShiftCorrelatedPeriod(const FrameInfo &frame, RelativeTimestamp *times) const;
+    void Rebase(size_t timestamp);
+
+    PolicyVector<FrameInfo> frames_;
+    PolicyVector<RelativeTimestamp> access_times_;
+    size_t epoch_{0};             // 相对时间戳的零点，受 latch_ 保护
+    PolicyVector<frame_id_t> evict_heap_;
+    std::vector<AccessStripe> stripes_;
+    std::vector<Access> drained_; // DrainAccesses 的临时数组，容量在构造时预留
+    size_t dirty_tolerance_{0};
+    EvictionCallback eviction_callback_;
+
+    // 统计计数器，未定义 BUSTUB_ENABLE_STATS 时为空对象
+    struct StatCounters
+    {
+      StatCounter evictions_scan_;
+      StatCounter evictions_history_;
+      StatCounter evictions_cache_;
+      StatCounter failed_evicts_;
+      StatCounter evict_heap_steps_;
+      StatCounter buffer_full_;
+      StatCounter dirty_skips_;
+      LatchStatCounters latch_;
+    };
+    StatCounters stats_;
+    size_t heap_steps_{0}; // HeapSwap 的累计次数，受 latch_ 保护，只在统计开启时更新
   };
 
 } // namespace bustub
@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * A correlated burst counts as one reference that ends at the last access of the burst (the LRU-K
+ * paper's HIST(i) = HIST(i-1) + correl_period), so the k-distance of A is measured from the end of
+ * its burst, which comes after B's first access.
+ */
+TEST(LRUKReplacerTest, CorrelatedBurstEndsAtLastAccess) {
+  const size_t correlated_period = 2;
+  LRUKReplacer lru_replacer(3, 2, correlated_period);
+  const frame_id_t a = 0;
+  const frame_id_t b = 1;
+  const frame_id_t c = 2;  // Only advances the clock; never evictable
+
+  lru_replacer.RecordAccess(a);  // ts 1: A's burst starts
+  lru_replacer.RecordAccess(b);  // ts 2: B's first reference
+  lru_replacer.RecordAccess(a);  // ts 3: correlated with ts 1
+  lru_replacer.RecordAccess(a);  // ts 4: correlated, the burst ends here
+  lru_replacer.RecordAccess(c);  // ts 5
+  lru_replacer.RecordAccess(c);  // ts 6
+  lru_replacer.RecordAccess(b);  // ts 7: B's second reference, HIST(B) = {7, 2}
+  lru_replacer.RecordAccess(a);  // ts 8: A's second reference, HIST(A) = {8, 4}
+
+  lru_replacer.SetEvictable(a, true);
+  lru_replacer.SetEvictable(b, true);
+  ASSERT_EQ(2, lru_replacer.Size());
+
+  frame_id_t frame;
+  ASSERT_TRUE(lru_replacer.Evict(&frame));
+  EXPECT_EQ(b, frame);
+  ASSERT_TRUE(lru_replacer.Evict(&frame));
+  EXPECT_EQ(a, frame);
+  EXPECT_FALSE(lru_replacer.Evict(&frame));
+}
+
+}  // namespace bustub
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_policy.cpp
+//
+// Identification: src/common/memory_policy.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/memory_policy.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace bustub {
+
+namespace {
+#ifdef __linux__
+constexpr size_t BASE_PAGE_SIZE = 4096;
+
+auto UsesHugePages(size_t bytes, const MemoryPolicy &policy) -> bool {
+  return policy.huge_pages_ && bytes >= HUGE_PAGE_SIZE;
+}
+
+// 只有大页或 NUMA 放置需要自己映射内存，其余情况（包括所有小区域）都交给 operator new
+auto UsesMapping(size_t bytes, const MemoryPolicy &policy) -> bool {
+  return UsesHugePages(bytes, policy) || (policy.placement_ != NumaPlacement::Default && bytes >= BASE_PAGE_SIZE);
+}
+
+// 映射的长度：使用大页时向上取整到大页，否则取整到普通页。分配与释放用同一个长度
+auto MappedSize(size_t bytes, const MemoryPolicy &policy) -> size_t {
+  size_t unit = UsesHugePages(bytes, policy) ? HUGE_PAGE_SIZE : BASE_PAGE_SIZE;
+  return (bytes + unit - 1) / unit * unit;
+}
+
+constexpr size_t MAX_NUMA_NODES = 1024;
+constexpr int MPOL_BIND_MODE = 2;
+constexpr int MPOL_INTERLEAVE_MODE = 3;
+constexpr unsigned long MPOL_F_MEMS_ALLOWED_FLAG = 4;  // NOLINT
+
+/**
+ * @brief 映射一段匿名内存，失败返回 nullptr
+ *
+ * 优先使用预留的大页；没有预留大页时多映射一个大页，裁剪成 2MB 对齐的区域，
+ * 再用 MADV_HUGEPAGE 建议内核以透明大页填充。
+ */
+auto MapRegion(size_t len, bool huge) -> void * {
+  if (huge) {
+    void *region = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (region != MAP_FAILED) {
+      return region;
+    }
+    void *raw = mmap(nullptr, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+      return nullptr;
+    }
+    auto begin = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    if (aligned > begin) {
+      munmap(raw, aligned - begin);
+    }
+    size_t tail = begin + len + HUGE_PAGE_SIZE - (aligned + len);
+    if (tail > 0) {
+      munmap(reinterpret_cast<void *>(aligned + len), tail);
+    }
+    madvise(reinterpret_cast<void *>(aligned), len, MADV_HUGEPAGE);
+    return reinterpret_cast<void *>(aligned);
+  }
+  void *region = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return region == MAP_FAILED ? nullptr : region;
+}
+
+/**
+ * @brief 在第一次访问之前用 mbind 设置区域的 NUMA 策略
+ *
+ * Interleave 使用本进程允许分配的所有节点。系统不支持 NUMA 或节点不存在时 mbind 失败，
+ * 区域保留默认放置。
+ */
+void ApplyPlacement(void *region, size_t len, const MemoryPolicy &policy) {
+  constexpr size_t bits_per_word = 8 * sizeof(unsigned long);  // NOLINT
+  unsigned long nodes[MAX_NUMA_NODES / bits_per_word] = {};    // NOLINT
+  int mode;
+  if (policy.placement_ == NumaPlacement::Bind) {
+    if (policy.numa_node_ < 0 || static_cast<size_t>(policy.numa_node_) >= MAX_NUMA_NODES) {
+      return;
+    }
+    nodes[policy.numa_node_ / bits_per_word] |= 1UL << (policy.numa_node_ % bits_per_word);
+    mode = MPOL_BIND_MODE;
+  } else {
+    int current_mode;
+    if (syscall(SYS_get_mempolicy, &current_mode, nodes, MAX_NUMA_NODES + 1, nullptr, MPOL_F_MEMS_ALLOWED_FLAG) != 0) {
+      return;
+    }
+    mode = MPOL_INTERLEAVE_MODE;
+  }
+  syscall(SYS_mbind, region, len, mode, nodes, MAX_NUMA_NODES + 1, 0);
+}
+#endif
+
+}  // namespace
+
+auto AllocateMemory(size_t bytes, const MemoryPolicy &policy) -> void * {
+#ifdef __linux__
+  if (UsesMapping(bytes, policy)) {
+    size_t len = MappedSize(bytes, policy);
+    void *region = MapRegion(len, UsesHugePages(bytes, policy));
+    if (region == nullptr) {
+      throw std::bad_alloc();
+    }
+    if (policy.placement_ != NumaPlacement::Default) {
+      ApplyPlacement(region, len, policy);
+    }
+    return region;
+  }
+#endif
+  return ::operator new(std::max<size_t>(bytes, 1), std::align_val_t(CACHE_LINE_SIZE));
+}
+
+void FreeMemory(void *ptr, size_t bytes, const MemoryPolicy &policy) {
+  if (ptr == nullptr) {
+    return;
+  }
+#ifdef __linux__
+  if (UsesMapping(bytes, policy)) {
+    munmap(ptr, MappedSize(bytes, policy));
+    return;
+  }
+#endif
+  ::operator delete(ptr, std::align_val_t(CACHE_LINE_SIZE));
+}
+
+}  // namespace bustub
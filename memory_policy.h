@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_policy.h
+//
+// Identification: src/include/common/memory_policy.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace bustub {
+
+/** Size of a cache line, the minimum alignment of every allocation made through a MemoryPolicy. */
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+/** Size of a huge page on x86-64 and aarch64 with 4KB base pages. */
+static constexpr size_t HUGE_PAGE_SIZE = 2UL << 20;
+
+/** Where the pages of a region are placed on a NUMA machine. */
+enum class NumaPlacement {
+  Default,     // The process's policy, usually the node of the first thread that touches a page
+  Bind,        // MemoryPolicy::numa_node_
+  Interleave,  // Round-robin over every node the process may allocate from
+};
+
+/**
+ * How the large arrays of a data structure are backed: the directory and bucket slabs of
+ * ExtendibleHashTable, the per-frame arrays of LRUKReplacer. The default policy is plain operator new.
+ *
+ * With huge_pages_ set, a region of at least HUGE_PAGE_SIZE is mapped from the reserved huge page
+ * pool (MAP_HUGETLB) if possible, and otherwise mapped 2MB-aligned and marked MADV_HUGEPAGE so that
+ * transparent huge pages can back it. A placement other than Default maps any region of at least a
+ * page and applies it with mbind before the first touch. Smaller regions always come from operator new.
+ *
+ * Both settings are hints: a region whose huge pages or placement the kernel refuses is still
+ * allocated, with ordinary pages or the default placement. Placement is only available on Linux.
+ */
+struct MemoryPolicy {
+  bool huge_pages_{false};
+  NumaPlacement placement_{NumaPlacement::Default};
+  int numa_node_{0};  // The node to bind to; ignored unless placement_ is Bind
+
+  auto operator==(const MemoryPolicy &other) const -> bool {
+    return huge_pages_ == other.huge_pages_ && placement_ == other.placement_ && numa_node_ == other.numa_node_;
+  }
+  auto operator!=(const MemoryPolicy &other) const -> bool { return !(*this == other); }
+};
+
+/**
+ * @brief Allocate a CACHE_LINE_SIZE-aligned region as the policy asks.
+ * @param bytes The size of the region.
+ * @param policy The policy to back the region with.
+ * @return The region; throws std::bad_alloc if no memory is available at all.
+ */
+auto AllocateMemory(size_t bytes, const MemoryPolicy &policy) -> void *;
+
+/** @brief Free a region returned by AllocateMemory with the same size and policy. */
+void FreeMemory(void *ptr, size_t bytes, const MemoryPolicy &policy);
+
+/**
+ * Standard allocator over AllocateMemory, so that std::vector can be backed by a MemoryPolicy.
+ */
+template <typename T>
+class PolicyAllocator {
+ public:
+  using value_type = T;
+
+  PolicyAllocator() = default;
+
+  explicit PolicyAllocator(const MemoryPolicy &policy) : policy_(policy) {}
+
+  template <typename U>
+  PolicyAllocator(const PolicyAllocator<U> &other) : policy_(other.GetPolicy()) {}  // NOLINT
+
+  auto allocate(size_t n) -> T * { return static_cast<T *>(AllocateMemory(n * sizeof(T), policy_)); }  // NOLINT
+
+  void deallocate(T *ptr, size_t n) { FreeMemory(ptr, n * sizeof(T), policy_); }  // NOLINT
+
+  auto GetPolicy() const -> const MemoryPolicy & { return policy_; }
+
+  template <typename U>
+  auto operator==(const PolicyAllocator<U> &other) const -> bool {
+    return policy_ == other.GetPolicy();
+  }
+  template <typename U>
+  auto operator!=(const PolicyAllocator<U> &other) const -> bool {
+    return policy_ != other.GetPolicy();
+  }
+
+ private:
+  MemoryPolicy policy_;
+};
+
+/** A vector whose storage is backed by a MemoryPolicy. */
+template <typename T>
+using PolicyVector = std::vector<T, PolicyAllocator<T>>;
+
+}  // namespace bustub
@@ -0,0 +1,170 @@
+#include "buffer/partitioned_lru_k_replacer.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread> // NOLINT
+
+namespace bustub
+{
+
+  /*构造函数：把帧平均分成 num_shards 个连续区间，最后一个分片可能较小
+   分片内部使用从0开始的帧编号。
+  */
+  PartitionedLRUKReplacer::PartitionedLRUKReplacer(size_t num_frames, size_t k, size_t num_shards,
+                                                   size_t correlated_period, const MemoryPolicy &memory_policy)
+      : replacer_size_(num_frames)
+  {
+    num_shards = std::max<size_t>(1, std::min(num_shards, num_frames));
+    frames_per_shard_ = std::max<size_t>(1, (num_frames + num_shards - 1) / num_shards);
+    for (size_t base = 0; base < num_frames; base += frames_per_shard_)
+    {
+      shards_.push_back(
+          std::make_unique<LRUKReplacer>(std::min(frames_per_shard_, num_frames - base), k, correlated_period,
+                                         memory_policy));
+    }
+    if (shards_.empty())
+    {
+      shards_.push_back(std::make_unique<LRUKReplacer>(0, k, correlated_period, memory_policy));
+    }
+  }
+
+  // Evict：从调用线程的本地分片开始淘汰，本地分片由线程 id 决定
+  auto PartitionedLRUKReplacer::Evict(frame_id_t *frame_id) -> bool
+  {
+    return EvictFrom(HomeShard(), frame_id);
+  }
+
+  auto PartitionedLRUKReplacer::HomeShard() const -> size_t
+  {
+    thread_local const size_t home = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return home % shards_.size();
+  }
+
+  // EvictBatch：与 EvictFrom 的顺序相同，先从本地分片批量淘汰，不够时再依次从后面的分片补足
+  auto PartitionedLRUKReplacer::EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t
+  {
+    size_t home = HomeShard();
+    size_t evicted = 0;
+    for (size_t i = 0; i < shards_.size() && evicted < n; i++)
+    {
+      size_t s = (home + i) % shards_.size();
+      size_t count = shards_[s]->EvictBatch(n - evicted, &frame_ids[evicted]);
+      for (size_t j = evicted; j < evicted + count; j++)
+      {
+        frame_ids[j] += static_cast<frame_id_t>(s * frames_per_shard_);
+      }
+      evicted += count;
+    }
+    return evicted;
+  }
+
+  auto PartitionedLRUKReplacer::PeekVictims(size_t n) -> std::vector<frame_id_t>
+  {
+    size_t home = HomeShard();
+    std::vector<frame_id_t> victims;
+    for (size_t i = 0; i < shards_.size() && victims.size() < n; i++)
+    {
+      size_t s = (home + i) % shards_.size();
+      for (frame_id_t local : shards_[s]->PeekVictims(n - victims.size()))
+      {
+        victims.push_back(static_cast<frame_id_t>(s * frames_per_shard_) + local);
+      }
+    }
+    return victims;
+  }
+
+  /*EvictFrom：依次尝试从 shard 开始的每个分片，返回第一个成功淘汰的帧
+   每次只持有一个分片的锁。
+  */
+  auto PartitionedLRUKReplacer::EvictFrom(size_t shard, frame_id_t *frame_id) -> bool
+  {
+    BUSTUB_ASSERT(shard < shards_.size(), "Invalid shard!");
+    for (size_t i = 0; i < shards_.size(); i++)
+    {
+      size_t s = (shard + i) % shards_.size();
+      frame_id_t local;
+      if (shards_[s]->Evict(&local))
+      {
+        *frame_id = static_cast<frame_id_t>(s * frames_per_shard_) + local;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void PartitionedLRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id)
+  {
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    size_t s = ShardOf(frame_id);
+    shards_[s]->RecordAccess(frame_id - static_cast<frame_id_t>(s * frames_per_shard_), access_type, page_id);
+  }
+
+  void PartitionedLRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable)
+  {
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    size_t s = ShardOf(frame_id);
+    shards_[s]->SetEvictable(frame_id - static_cast<frame_id_t>(s * frames_per_shard_), set_evictable);
+  }
+
+  void PartitionedLRUKReplacer::SetDirty(frame_id_t frame_id, bool dirty)
+  {
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    size_t s = ShardOf(frame_id);
+    shards_[s]->SetDirty(frame_id - static_cast<frame_id_t>(s * frames_per_shard_), dirty);
+  }
+
+  void PartitionedLRUKReplacer::SetDirtyTolerance(size_t tolerance)
+  {
+    for (auto &shard : shards_)
+    {
+      shard->SetDirtyTolerance(tolerance);
+    }
+  }
+
+  // 每个分片的回调把分片内的帧编号换算回全局帧编号
+  void PartitionedLRUKReplacer::SetEvictionCallback(const LRUKReplacer::EvictionCallback &callback)
+  {
+    for (size_t s = 0; s < shards_.size(); s++)
+    {
+      if (!callback)
+      {
+        shards_[s]->SetEvictionCallback(nullptr);
+        continue;
+      }
+      auto base = static_cast<frame_id_t>(s * frames_per_shard_);
+      shards_[s]->SetEvictionCallback(
+          [callback, base](frame_id_t frame_id, bool dirty) { callback(base + frame_id, dirty); });
+    }
+  }
+
+  void PartitionedLRUKReplacer::Remove(frame_id_t frame_id)
+  {
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_)
+    {
+      return; // 与 LRUKReplacer::Remove 一样忽略不存在的帧
+    }
+    size_t s = ShardOf(frame_id);
+    shards_[s]->Remove(frame_id - static_cast<frame_id_t>(s * frames_per_shard_));
+  }
+
+  auto PartitionedLRUKReplacer::Size() -> size_t
+  {
+    size_t size = 0;
+    for (auto &shard : shards_)
+    {
+      size += shard->Size();
+    }
+    return size;
+  }
+
+  auto PartitionedLRUKReplacer::GetStats() const -> LRUKReplacer::Stats
+  {
+    LRUKReplacer::Stats stats{};
+    for (const auto &shard : shards_)
+    {
+      stats += shard->GetStats();
+    }
+    return stats;
+  }
+
+} // namespace bustub
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  /**
+   * PartitionedLRUKReplacer splits the frames into num_shards contiguous ranges, each run by its own
+   * LRUKReplacer with its own latch, so operations on different shards never contend.
+   *
+   * Evict tries the calling thread's home shard first and steals from the following shards when it
+   * has no evictable frame; EvictFrom does the same starting at a given shard, for a caller (such as
+   * a per-NUMA-node buffer pool) that owns one. The victim is the LRU-K choice within the first
+   * shard that has one, not across all frames.
+   */
+  class PartitionedLRUKReplacer : public Replacer
+  {
+  public:
+    /**
+     * @param num_frames The number of frames the replacer tracks.
+     * @param k The k of every shard's LRU-K.
+     * @param num_shards The number of shards, at most num_frames.
+     * @param correlated_period The correlated reference period of every shard (see LRUKReplacer).
+     * @param memory_policy How every shard's arrays are backed (see LRUKReplacer).
+     */
+    PartitionedLRUKReplacer(size_t num_frames, size_t k, size_t num_shards, size_t correlated_period = 0,
+                            const MemoryPolicy &memory_policy = MemoryPolicy());
+
+    DISALLOW_COPY_AND_MOVE(PartitionedLRUKReplacer);
+
+    ~PartitionedLRUKReplacer() override = default;
+
+    auto Evict(frame_id_t *frame_id) -> bool override;
+
+    /**
+     * @brief Evict from shard first, then from the shards after it in turn.
+     * @param shard The shard to try first, less than GetNumShards().
+     */
+    auto EvictFrom(size_t shard, frame_id_t *frame_id) -> bool;
+
+    /**
+     * @brief Evict up to n frames, taking as many as possible from the home shard before moving on
+     * to the next one, with one latch acquisition per shard visited.
+     */
+    auto EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t override;
+
+    /**
+     * @brief The frames EvictBatch(n) would return if called now from this thread, without evicting
+     * them; see LRUKReplacer::PeekVictims.
+     */
+    auto PeekVictims(size_t n) -> std::vector<frame_id_t>;
+
+    void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                      page_id_t page_id = INVALID_PAGE_ID) override;
+
+    void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+    void SetDirty(frame_id_t frame_id, bool dirty) override;
+
+    /** @brief Set the dirty tolerance of every shard; see LRUKReplacer::SetDirtyTolerance. */
+    void SetDirtyTolerance(size_t tolerance);
+
+    /** @brief Set the eviction callback of every shard, with global frame ids. */
+    void SetEvictionCallback(const LRUKReplacer::EvictionCallback &callback);
+
+    void Remove(frame_id_t frame_id) override;
+
+    /** @return The number of evictable frames over all shards, each counted under its own latch. */
+    auto Size() -> size_t override;
+
+    /** @brief Sum the counters of every shard; see LRUKReplacer::GetStats. */
+    auto GetStats() const -> LRUKReplacer::Stats;
+
+    auto GetNumShards() const -> size_t { return shards_.size(); }
+
+    /** @return The shard that frame_id belongs to. */
+    auto ShardOf(frame_id_t frame_id) const -> size_t { return frame_id / frames_per_shard_; }
+
+  private:
+    auto HomeShard() const -> size_t;
+
+    size_t replacer_size_;
+    size_t frames_per_shard_;
+    // 第 s 个分片管理帧 [s * frames_per_shard_, (s + 1) * frames_per_shard_)
+    std::vector<std::unique_ptr<LRUKReplacer>> shards_;
+  };
+
+} // namespace bustub
@@ -0,0 +1,48 @@
+#include "buffer/replacer.h"
+
+#include <thread> // NOLINT
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/partitioned_lru_k_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  auto Replacer::EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t
+  {
+    size_t evicted = 0;
+    while (evicted < n && Evict(&frame_ids[evicted]))
+    {
+      evicted++;
+    }
+    return evicted;
+  }
+
+  auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k, size_t num_shards)
+      -> std::unique_ptr<Replacer>
+  {
+    switch (policy)
+    {
+    case ReplacerPolicy::LRUK:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerPolicy::PartitionedLRUK:
+      if (num_shards == 0)
+      {
+        num_shards = std::thread::hardware_concurrency();
+      }
+      return std::make_unique<PartitionedLRUKReplacer>(num_frames, k, num_shards);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ArcReplacer>(num_frames);
+    case ReplacerPolicy::TwoQueue:
+      return std::make_unique<TwoQueueReplacer>(num_frames);
+    case ReplacerPolicy::Clock:
+      return std::make_unique<ClockReplacer>(num_frames);
+    }
+    UNREACHABLE("unknown replacer policy");
+  }
+
+} // namespace bustub
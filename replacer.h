@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "common/config.h"
+
+namespace bustub
+{
+
+  /**
+   * How a page is being accessed. Scan marks accesses made by a sequential scan, whose pages are
+   * usually touched once and should not displace the working set.
+   */
+  enum class AccessType
+  {
+    Unknown = 0,
+    Lookup,
+    Scan,
+    Index
+  };
+
+  /**
+   * Replacer is the interface the buffer pool uses to pick the frame to evict. A frame is tracked
+   * from its first RecordAccess until it is evicted or removed, and only evictable frames are
+   * candidates for Evict.
+   */
+  class Replacer
+  {
+  public:
+    Replacer() = default;
+    virtual ~Replacer() = default;
+
+    /**
+     * @brief Evict a frame chosen by the policy and stop tracking it.
+     * @param[out] frame_id The evicted frame.
+     * @return false if there is no evictable frame.
+     */
+    virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+    /**
+     * @brief Evict up to n frames, best victim first, with the same choices n calls to Evict would
+     * make. The default calls Evict n times; policies override it to take their latch only once.
+     * @param[out] frame_ids The evicted frames; must have room for n.
+     * @return The number of frames evicted, less than n only if no evictable frame is left.
+     */
+    virtual auto EvictBatch(size_t n, frame_id_t *frame_ids) -> size_t;
+
+    /**
+     * @brief Record an access to frame_id.
+     * @param access_type The kind of access; policies may use it to keep scans from flushing the cache.
+     * @param page_id The page held by the frame. Policies with ghost history (ARC, 2Q) remember the
+     * pages of evicted frames by it and recognise them when they are read back into any frame;
+     * without it they still work, but never see a ghost hit.
+     */
+    virtual void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                              page_id_t page_id = INVALID_PAGE_ID) = 0;
+
+    /** @brief Mark a tracked frame evictable or not; Size counts only evictable frames. */
+    virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
+
+    /**
+     * @brief Tell the policy whether the page in a tracked frame is dirty, as a hint that evicting it
+     * costs a write. Policies that do not use the hint ignore it.
+     */
+    virtual void SetDirty(frame_id_t /*frame_id*/, bool /*dirty*/) {}
+
+    /**
+     * @brief Stop tracking a frame whose page was deleted; no ghost history is kept for it.
+     * Throws std::runtime_error if the frame is tracked but not evictable.
+     */
+    virtual void Remove(frame_id_t frame_id) = 0;
+
+    /** @return The number of evictable frames. */
+    virtual auto Size() -> size_t = 0;
+  };
+
+  /** The replacement policies MakeReplacer can build. */
+  enum class ReplacerPolicy
+  {
+    LRUK,
+    PartitionedLRUK,
+    ARC,
+    TwoQueue,
+    Clock
+  };
+
+  /**
+   * @brief Build a replacer for num_frames frames.
+   * @param k The k of LRU-K; ignored by the other policies.
+   * @param num_shards The number of shards of PartitionedLRUK; 0 picks one per hardware thread.
+   */
+  auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k = 2, size_t num_shards = 0)
+      -> std::unique_ptr<Replacer>;
+
+} // namespace bustub
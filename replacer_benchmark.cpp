@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.cpp
+//
+// Identification: tools/benchmark/replacer_benchmark.cpp
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Google Benchmark microbenchmarks for the replacement policies. Arguments are
+ * {policy, number of frames, k}, where policy is a ReplacerPolicy value; k only matters to LRU-K.
+ *
+ *    ./replacer_benchmark --benchmark_filter=HitRatio
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "buffer/replacer.h"
+
+namespace bustub {
+namespace {
+
+auto PolicyName(int64_t policy) -> const char * {
+  switch (static_cast<ReplacerPolicy>(policy)) {
+    case ReplacerPolicy::LRUK:
+      return "lru_k";
+    case ReplacerPolicy::PartitionedLRUK:
+      return "partitioned_lru_k";
+    case ReplacerPolicy::ARC:
+      return "arc";
+    case ReplacerPolicy::TwoQueue:
+      return "2q";
+    case ReplacerPolicy::Clock:
+      return "clock";
+  }
+  return "unknown";
+}
+
+auto MakeFullReplacer(benchmark::State &state) -> std::unique_ptr<Replacer> {
+  auto num_frames = static_cast<size_t>(state.range(1));
+  auto replacer = MakeReplacer(static_cast<ReplacerPolicy>(state.range(0)), num_frames, state.range(2));
+  for (size_t i = 0; i < num_frames; i++) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    replacer->RecordAccess(frame_id, AccessType::Lookup, frame_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  return replacer;
+}
+
+std::unique_ptr<Replacer> shared_replacer;
+
+/** 缓冲池命中的开销：只记录访问，所有线程共享一个替换器 */
+void BM_RecordAccess(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_replacer = MakeFullReplacer(state);
+  }
+  XorShift rng(state.thread_index());
+  auto num_frames = static_cast<uint64_t>(state.range(1));
+  for (auto _ : state) {
+    auto frame_id = static_cast<frame_id_t>(rng.Next() % num_frames);
+    shared_replacer->RecordAccess(frame_id, AccessType::Lookup, frame_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(PolicyName(state.range(0)));
+  if (state.thread_index() == 0) {
+    shared_replacer.reset();
+  }
+}
+
+/** 缓冲池未命中的开销：淘汰一个帧，再把新页面放进这个帧 */
+void BM_EvictCycle(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    shared_replacer = MakeFullReplacer(state);
+  }
+  auto page_id = static_cast<page_id_t>(state.range(1) + state.thread_index());
+  for (auto _ : state) {
+    frame_id_t frame_id;
+    if (shared_replacer->Evict(&frame_id)) {
+      shared_replacer->RecordAccess(frame_id, AccessType::Lookup, page_id);
+      shared_replacer->SetEvictable(frame_id, true);
+    }
+    page_id += state.threads();
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(PolicyName(state.range(0)));
+  if (state.thread_index() == 0) {
+    shared_replacer.reset();
+  }
+}
+
+/**
+ * 命中率：模拟一个没有固定页面的缓冲池。80% 的访问均匀落在占总页面 5% 的热点集合上，
+ * 其余访问顺序扫描冷页面并标记为 AccessType::Scan。页面总数为帧数的 10 倍。
+ */
+void BM_HitRatio(benchmark::State &state) {
+  auto num_frames = static_cast<size_t>(state.range(1));
+  size_t num_pages = num_frames * 10;
+  size_t hot_pages = num_pages / 20;
+  auto replacer = MakeReplacer(static_cast<ReplacerPolicy>(state.range(0)), num_frames, state.range(2));
+  std::vector<frame_id_t> page_frame(num_pages, -1);
+  std::vector<page_id_t> frame_page(num_frames, INVALID_PAGE_ID);
+  size_t used_frames = 0;
+  size_t scan_cursor = hot_pages;
+  XorShift rng(42);
+  int64_t hits = 0;
+  for (auto _ : state) {
+    bool scan = rng.Next() % 5 == 0;
+    page_id_t page_id;
+    if (scan) {
+      page_id = static_cast<page_id_t>(scan_cursor);
+      scan_cursor = scan_cursor + 1 == num_pages ? hot_pages : scan_cursor + 1;
+    } else {
+      page_id = static_cast<page_id_t>(rng.Next() % hot_pages);
+    }
+    AccessType access_type = scan ? AccessType::Scan : AccessType::Lookup;
+
+    frame_id_t frame_id = page_frame[page_id];
+    if (frame_id >= 0) {
+      hits++;
+      replacer->RecordAccess(frame_id, access_type, page_id);
+      continue;
+    }
+    if (used_frames < num_frames) {
+      frame_id = static_cast<frame_id_t>(used_frames++);
+    } else {
+      replacer->Evict(&frame_id);
+      page_frame[frame_page[frame_id]] = -1;
+    }
+    page_frame[page_id] = frame_id;
+    frame_page[frame_id] = page_id;
+    replacer->RecordAccess(frame_id, access_type, page_id);
+    replacer->SetEvictable(frame_id, true);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(PolicyName(state.range(0)));
+  state.counters["hit_ratio"] = static_cast<double>(hits) / static_cast<double>(state.iterations());
+}
+
+void PolicyArgs(benchmark::internal::Benchmark *b) {
+  for (auto policy : {ReplacerPolicy::LRUK, ReplacerPolicy::PartitionedLRUK, ReplacerPolicy::ARC,
+                      ReplacerPolicy::TwoQueue, ReplacerPolicy::Clock}) {
+    for (int64_t num_frames : {1 << 10, 1 << 16}) {
+      for (int64_t k : {2, 4}) {
+        if (k != 2 && policy != ReplacerPolicy::LRUK && policy != ReplacerPolicy::PartitionedLRUK) {
+          continue;
+        }
+        b->Args({static_cast<int64_t>(policy), num_frames, k});
+      }
+    }
+  }
+}
+
+BENCHMARK(BM_RecordAccess)->Apply(PolicyArgs)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_EvictCycle)->Apply(PolicyArgs)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_HitRatio)->Apply(PolicyArgs);
+
+}  // namespace
+}  // namespace bustub
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_test.cpp
+//
+// Identification: test/buffer/replacer_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <stdexcept>
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/two_queue_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ReplacerTest, ArcGhostHitPromotesToT2) {
+  ArcReplacer arc_replacer(4);
+  for (frame_id_t frame = 0; frame < 4; frame++) {
+    arc_replacer.RecordAccess(frame, AccessType::Lookup, 10 + frame);
+    arc_replacer.SetEvictable(frame, true);
+  }
+  frame_id_t frame;
+  ASSERT_TRUE(arc_replacer.Evict(&frame));
+  EXPECT_EQ(0, frame);  // Page 10 is remembered in B1
+
+  // A hit in B1 grows the target size of T1 to 1 and admits the frame straight into T2, so it
+  // outlives the T1 frames until T1 is down to its target
+  arc_replacer.RecordAccess(0, AccessType::Lookup, 10);
+  arc_replacer.SetEvictable(0, true);
+  ASSERT_EQ(4, arc_replacer.Size());
+  for (frame_id_t expected : {1, 2, 0, 3}) {
+    ASSERT_TRUE(arc_replacer.Evict(&frame));
+    EXPECT_EQ(expected, frame);
+  }
+  EXPECT_FALSE(arc_replacer.Evict(&frame));
+  EXPECT_EQ(0, arc_replacer.Size());
+}
+
+TEST(ReplacerTest, ArcScanLeavesNoGhost) {
+  ArcReplacer arc_replacer(4);
+  for (frame_id_t frame = 0; frame < 4; frame++) {
+    arc_replacer.RecordAccess(frame, AccessType::Scan, 10 + frame);
+    arc_replacer.SetEvictable(frame, true);
+  }
+  frame_id_t frame;
+  ASSERT_TRUE(arc_replacer.Evict(&frame));
+  EXPECT_EQ(0, frame);
+
+  // Page 10 was only scanned, so reading it back is not a ghost hit: the frame enters T1
+  arc_replacer.RecordAccess(0, AccessType::Lookup, 10);
+  arc_replacer.SetEvictable(0, true);
+  for (frame_id_t expected : {1, 2, 3, 0}) {
+    ASSERT_TRUE(arc_replacer.Evict(&frame));
+    EXPECT_EQ(expected, frame);
+  }
+}
+
+TEST(ReplacerTest, TwoQueueA1outHitPromotesToAm) {
+  TwoQueueReplacer two_queue_replacer(4);
+  for (frame_id_t frame = 0; frame < 4; frame++) {
+    two_queue_replacer.RecordAccess(frame, AccessType::Lookup, 100 + frame);
+    two_queue_replacer.SetEvictable(frame, true);
+  }
+  frame_id_t frame;
+  ASSERT_TRUE(two_queue_replacer.Evict(&frame));
+  EXPECT_EQ(0, frame);  // Page 100 is remembered in A1out
+
+  // A hit in A1out admits the frame into Am, which is only evicted from once A1in is down to Kin
+  two_queue_replacer.RecordAccess(0, AccessType::Lookup, 100);
+  two_queue_replacer.SetEvictable(0, true);
+  for (frame_id_t expected : {1, 2, 0, 3}) {
+    ASSERT_TRUE(two_queue_replacer.Evict(&frame));
+    EXPECT_EQ(expected, frame);
+  }
+  EXPECT_FALSE(two_queue_replacer.Evict(&frame));
+}
+
+TEST(ReplacerTest, ClockSecondChance) {
+  ClockReplacer clock_replacer(3);
+  for (frame_id_t frame = 0; frame < 3; frame++) {
+    clock_replacer.RecordAccess(frame);
+    clock_replacer.SetEvictable(frame, true);
+  }
+  clock_replacer.RecordAccess(0);                    // Sets the reference bit: a second chance
+  clock_replacer.RecordAccess(2, AccessType::Scan);  // Scans never set it
+
+  frame_id_t frame;
+  for (frame_id_t expected : {1, 2, 0}) {
+    ASSERT_TRUE(clock_replacer.Evict(&frame));
+    EXPECT_EQ(expected, frame);
+  }
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
+TEST(ReplacerTest, RemoveThrowsOnPinnedFrame) {
+  std::unique_ptr<Replacer> replacers[] = {std::make_unique<ArcReplacer>(4), std::make_unique<TwoQueueReplacer>(4),
+                                           std::make_unique<ClockReplacer>(4)};
+  for (auto &replacer : replacers) {
+    replacer->RecordAccess(0, AccessType::Lookup, 10);
+    replacer->RecordAccess(1, AccessType::Lookup, 11);
+    replacer->SetEvictable(1, true);
+    ASSERT_EQ(1, replacer->Size());
+
+    EXPECT_THROW(replacer->Remove(0), std::runtime_error);
+    replacer->Remove(1);
+    replacer->Remove(2);  // Not tracked: ignored
+    EXPECT_EQ(0, replacer->Size());
+
+    // Frame 0 is still tracked and becomes the only victim once unpinned
+    replacer->SetEvictable(0, true);
+    frame_id_t frame;
+    ASSERT_TRUE(replacer->Evict(&frame));
+    EXPECT_EQ(0, frame);
+    EXPECT_FALSE(replacer->Evict(&frame));
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,321 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// shards_simulator.cpp
+//
+// Identification: tools/shards/shards_simulator.cpp
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Estimates hit ratio as a function of buffer pool size (a miss ratio curve) from a single pass
+ * over a page access trace, using SHARDS spatial sampling (Waldspurger et al., FAST '15).
+ *
+ * A page is sampled iff hash(page_id) falls below rate * 2^24, so every access to a sampled page
+ * is kept and the sampled trace has the reuse pattern of the full one at 1/rate the scale. Two
+ * curves are computed from it:
+ *  - lru: exact LRU stack distances of the sampled accesses, scaled by 1/rate, with the
+ *    SHARDS_adj correction of the sampled access count.
+ *  - the chosen policy (LRU-K by default): miniature simulations, i.e. one replacer with
+ *    size * rate frames per point of the curve, all fed the sampled trace. LRU-K is not a stack
+ *    algorithm, so its curve cannot be read off stack distances.
+ *
+ * The trace format is the one trace_replay reads. The trace is streamed, never held in memory.
+ *
+ *    ./shards_simulator trace.txt --rate 0.01 --max-frames 1048576 --points 24 --k 2 > mrc.csv
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+namespace {
+
+/** 采样哈希取低 24 位与阈值比较 */
+constexpr uint64_t SAMPLE_MODULUS = 1ULL << 24;
+
+/**
+ * 精确计算采样访问的 LRU 栈距离。每个页面在它最后一次访问的逻辑时间上打一个标记，
+ * 两次访问之间的栈距离就是这两个时间之间的标记数，用树状数组求和。
+ * 时间用尽时按顺序把仍然有效的标记重新编号，所以空间只与采样到的不同页面数成正比。
+ */
+class StackDistance {
+ public:
+  static constexpr uint64_t COLD = UINT64_MAX;
+
+  StackDistance() { Rebuild(MIN_CAPACITY); }
+
+  /** @return 访问 page_id 的栈距离，第一次访问返回 COLD */
+  auto Access(page_id_t page_id) -> uint64_t {
+    if (now_ == time_page_.size()) {
+      Compact();
+    }
+    uint64_t distance = COLD;
+    auto it = last_access_.find(page_id);
+    if (it != last_access_.end()) {
+      size_t last = it->second;
+      distance = static_cast<uint64_t>(Prefix(now_) - Prefix(last + 1));
+      Update(last, -1);
+      time_page_[last] = INVALID_PAGE_ID;
+      it->second = now_;
+    } else {
+      last_access_.emplace(page_id, now_);
+    }
+    Update(now_, 1);
+    time_page_[now_] = page_id;
+    now_++;
+    return distance;
+  }
+
+  auto DistinctPages() const -> size_t { return last_access_.size(); }
+
+ private:
+  static constexpr size_t MIN_CAPACITY = 1 << 16;
+
+  /** 返回时间 [0, end) 内的标记数 */
+  auto Prefix(size_t end) const -> int64_t {
+    int64_t sum = 0;
+    for (size_t i = end; i > 0; i -= i & (~i + 1)) {
+      sum += tree_[i];
+    }
+    return sum;
+  }
+
+  void Update(size_t time, int64_t delta) {
+    for (size_t i = time + 1; i < tree_.size(); i += i & (~i + 1)) {
+      tree_[i] += delta;
+    }
+  }
+
+  void Compact() {
+    std::vector<page_id_t> live;
+    live.reserve(last_access_.size());
+    for (page_id_t page_id : time_page_) {
+      if (page_id != INVALID_PAGE_ID) {
+        live.push_back(page_id);
+      }
+    }
+    Rebuild(std::max(MIN_CAPACITY, live.size() * 2));
+    for (page_id_t page_id : live) {
+      last_access_[page_id] = now_;
+      Update(now_, 1);
+      time_page_[now_++] = page_id;
+    }
+  }
+
+  void Rebuild(size_t capacity) {
+    time_page_.assign(capacity, INVALID_PAGE_ID);
+    tree_.assign(capacity + 1, 0);
+    now_ = 0;
+  }
+
+  std::unordered_map<page_id_t, size_t> last_access_;
+  std::vector<page_id_t> time_page_;
+  std::vector<int64_t> tree_;
+  size_t now_{0};
+};
+
+/** 一个缩小了 1/rate 倍的无固定页面的缓冲池，结构与 trace_replay 相同 */
+class MiniCache {
+ public:
+  MiniCache(ReplacerPolicy policy, size_t num_frames, size_t k)
+      : replacer_(MakeReplacer(policy, num_frames, k)), page_table_(16), frame_page_(num_frames, INVALID_PAGE_ID) {}
+
+  void Access(page_id_t page_id, AccessType access_type) {
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, frame_id)) {
+      hits_++;
+      replacer_->RecordAccess(frame_id, access_type, page_id);
+      return;
+    }
+    if (used_frames_ < frame_page_.size()) {
+      frame_id = static_cast<frame_id_t>(used_frames_++);
+    } else {
+      replacer_->Evict(&frame_id);
+      page_table_.Remove(frame_page_[frame_id]);
+    }
+    page_table_.Insert(page_id, frame_id);
+    frame_page_[frame_id] = page_id;
+    replacer_->RecordAccess(frame_id, access_type, page_id);
+    replacer_->SetEvictable(frame_id, true);
+  }
+
+  auto Hits() const -> uint64_t { return hits_; }
+
+ private:
+  std::unique_ptr<Replacer> replacer_;
+  ExtendibleHashTable<page_id_t, int, IntegerMixHash<page_id_t>> page_table_;
+  std::vector<page_id_t> frame_page_;
+  size_t used_frames_{0};
+  uint64_t hits_{0};
+};
+
+/** 从 1 到 max_frames 的几何级数，去掉取整后重复的点 */
+auto CacheSizes(size_t max_frames, size_t points) -> std::vector<size_t> {
+  std::vector<size_t> sizes;
+  double ratio =
+      points > 1 ? std::pow(static_cast<double>(max_frames), 1.0 / static_cast<double>(points - 1)) : 1.0;
+  double size = 1.0;
+  for (size_t i = 0; i < points; i++, size *= ratio) {
+    auto rounded = std::min(max_frames, static_cast<size_t>(std::llround(size)));
+    if (sizes.empty() || rounded > sizes.back()) {
+      sizes.push_back(rounded);
+    }
+  }
+  return sizes;
+}
+
+void Usage(const char *prog) {
+  std::cerr << "usage: " << prog
+            << " <trace|-> [--rate R] [--max-frames N] [--points P] [--k K]"
+               " [--policy lru_k|partitioned_lru_k|arc|2q|clock|none]\n";
+  std::exit(2);
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::ReplacerPolicy;
+  if (argc < 2) {
+    bustub::Usage(argv[0]);
+  }
+  std::string trace_path = argv[1];
+  double rate = 0.01;
+  size_t max_frames = 1 << 20;
+  size_t points = 24;
+  size_t k = 2;
+  std::string policy_arg = "lru_k";
+  for (int i = 2; i < argc; i++) {
+    std::string flag = argv[i];
+    if (i + 1 == argc) {
+      bustub::Usage(argv[0]);
+    }
+    std::string value = argv[++i];
+    if (flag == "--rate") {
+      rate = std::stod(value);
+    } else if (flag == "--max-frames") {
+      max_frames = std::stoul(value);
+    } else if (flag == "--points") {
+      points = std::stoul(value);
+    } else if (flag == "--k") {
+      k = std::stoul(value);
+    } else if (flag == "--policy") {
+      policy_arg = value;
+    } else {
+      bustub::Usage(argv[0]);
+    }
+  }
+  if (!(rate > 0 && rate <= 1) || max_frames == 0 || points == 0 || k == 0) {
+    bustub::Usage(argv[0]);
+  }
+  const ReplacerPolicy *policy = nullptr;
+  const char *policy_name = nullptr;
+  for (const auto &entry : bustub::POLICIES) {
+    if (policy_arg == entry.name_) {
+      policy = &entry.policy_;
+      policy_name = entry.name_;
+    }
+  }
+  if (policy == nullptr && policy_arg != "none") {
+    bustub::Usage(argv[0]);
+  }
+
+  std::ifstream file;
+  if (trace_path != "-") {
+    file.open(trace_path);
+    if (!file) {
+      std::cerr << "cannot open trace " << trace_path << "\n";
+      return 1;
+    }
+  }
+  bustub::TraceReader reader(trace_path == "-" ? std::cin : file);
+
+  // 曲线上的点取在采样空间中，每个点是整数个帧，对应全量空间中的 frames / rate 个帧
+  auto threshold = std::max<uint64_t>(1, static_cast<uint64_t>(rate * static_cast<double>(bustub::SAMPLE_MODULUS)));
+  rate = static_cast<double>(threshold) / static_cast<double>(bustub::SAMPLE_MODULUS);
+  auto max_sampled_frames = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(max_frames) * rate));
+  std::vector<size_t> sizes = bustub::CacheSizes(max_sampled_frames, points);
+  std::vector<std::unique_ptr<bustub::MiniCache>> minis;
+  if (policy != nullptr) {
+    for (size_t frames : sizes) {
+      minis.push_back(std::make_unique<bustub::MiniCache>(*policy, frames, k));
+    }
+  }
+
+  bustub::StackDistance stack;
+  bustub::IntegerMixHash<bustub::page_id_t> hash;
+  std::vector<uint64_t> histogram;  // histogram[d]：采样空间中栈距离为 d 的访问数
+  uint64_t total = 0;
+  uint64_t sampled = 0;
+  bustub::TraceRecord record;
+  try {
+    while (reader.Next(&record)) {
+      total++;
+      if ((hash(record.page_id_) & (bustub::SAMPLE_MODULUS - 1)) >= threshold) {
+        continue;
+      }
+      sampled++;
+      uint64_t distance = stack.Access(record.page_id_);
+      if (distance != bustub::StackDistance::COLD) {
+        if (distance >= histogram.size()) {
+          histogram.resize(distance + 1);
+        }
+        histogram[distance]++;
+      }
+      for (auto &mini : minis) {
+        mini->Access(record.page_id_, record.access_type_);
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  /*
+   SHARDS_adj：采样到的访问数与期望值之差全部算作距离 0 的访问，用期望值作分母。
+   少数很热的页面是否被采样会让采样访问数大幅偏离期望值，迷你模拟的命中数做同样的修正。
+  */
+  double expected = static_cast<double>(total) * rate;
+  double adjust = expected - static_cast<double>(sampled);
+  std::fprintf(stderr, "%llu accesses, %llu sampled (rate %.6f), ~%.0f distinct pages\n",
+               static_cast<unsigned long long>(total), static_cast<unsigned long long>(sampled),  // NOLINT
+               rate, static_cast<double>(stack.DistinctPages()) / rate);
+  if (sampled == 0 || expected <= 0) {
+    std::cerr << "no accesses were sampled; raise --rate\n";
+    return 1;
+  }
+
+  std::printf("frames,lru_hit_ratio%s%s\n", policy_name != nullptr ? "," : "",
+              policy_name != nullptr ? (std::string(policy_name) + "_hit_ratio").c_str() : "");
+  double lru_hits = adjust;
+  size_t d = 0;
+  for (size_t i = 0; i < sizes.size(); i++) {
+    // 栈距离为 d 的访问在 frames 个帧的 LRU 缓存中命中，当且仅当 d < frames
+    while (d < histogram.size() && d < sizes[i]) {
+      lru_hits += static_cast<double>(histogram[d++]);
+    }
+    auto frames = static_cast<size_t>(std::llround(static_cast<double>(sizes[i]) / rate));
+    double lru = std::clamp(lru_hits / expected, 0.0, 1.0);
+    if (minis.empty()) {
+      std::printf("%zu,%.6f\n", frames, lru);
+    } else {
+      double mini = std::clamp((static_cast<double>(minis[i]->Hits()) + adjust) / expected, 0.0, 1.0);
+      std::printf("%zu,%.6f,%.6f\n", frames, lru, mini);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// stats.h
+//
+// Identification: src/include/common/stats.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <type_traits>
+
+namespace bustub {
+
+/**
+ * Hot-path statistics are compiled in only when BUSTUB_ENABLE_STATS is defined. Otherwise every
+ * counter is an empty object and every update is an inline no-op, so instrumented code costs
+ * nothing; GetStats() then reports zero for the counted fields.
+ */
+#ifdef BUSTUB_ENABLE_STATS
+static constexpr bool STATS_ENABLED = true;
+#else
+static constexpr bool STATS_ENABLED = false;
+#endif
+
+/**
+ * A counter striped over cache-line-sized cells. A thread always adds to the same cell with a
+ * relaxed atomic add, so threads on different cells never share a line; Load() sums the cells.
+ */
+class ShardedCounter {
+ public:
+  static constexpr size_t CELLS = 16;
+
+  inline void Add(uint64_t n = 1) { cells_[CellIndex()].value_.fetch_add(n, std::memory_order_relaxed); }
+
+  auto Load() const -> uint64_t {
+    uint64_t sum = 0;
+    for (const Cell &cell : cells_) {
+      sum += cell.value_.load(std::memory_order_relaxed);
+    }
+    return sum;
+  }
+
+ private:
+  struct alignas(64) Cell {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  static inline auto CellIndex() -> size_t {
+    thread_local const size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % CELLS;
+    return index;
+  }
+
+  std::array<Cell, CELLS> cells_;
+};
+
+/** The counter used when statistics are compiled out. */
+class NoopCounter {
+ public:
+  inline void Add(uint64_t /*n*/ = 1) {}
+  auto Load() const -> uint64_t { return 0; }
+};
+
+using StatCounter = std::conditional_t<STATS_ENABLED, ShardedCounter, NoopCounter>;
+
+/** How often a latch had to be waited for, and for how long in total. */
+struct LatchStatCounters {
+  StatCounter contended_;
+  StatCounter wait_ns_;
+};
+
+/**
+ * @brief Acquire mutex through a Lock (std::unique_lock or std::shared_lock), recording in stats
+ * whether the fast try-lock failed and how long the blocking acquire took.
+ */
+template <typename Lock, typename Mutex>
+inline auto AcquireLatch(Mutex &mutex, LatchStatCounters &stats) -> Lock {
+  if constexpr (STATS_ENABLED) {
+    Lock lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      auto start = std::chrono::steady_clock::now();
+      lock.lock();
+      stats.contended_.Add();
+      stats.wait_ns_.Add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    return lock;
+  } else {
+    return Lock(mutex);
+  }
+}
+
+}  // namespace bustub
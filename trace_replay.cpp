@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// trace_replay.cpp
+//
+// Identification: tools/trace_replay/trace_replay.cpp
+//
+//===----------------------------------------------------------------------===//
+
+/**
+ * Replays a page access trace against a simulated buffer pool: an ExtendibleHashTable page table
+ * in front of a replacer, with no pinning. Prints hit ratio and time per access for every policy.
+ *
+ * The trace is text with one access per line, "<page_id> [L|S|I]", where the optional letter is
+ * the AccessType (Lookup, Scan, Index; Unknown when omitted). Blank lines and '#' comments are
+ * skipped; TraceReader in buffer/access_trace.h parses it.
+ *
+ *    ./trace_replay trace.txt --frames 1024 --k 2 --policy all --hash mix
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "buffer/access_trace.h"
+#include "buffer/replacer.h"
+#include "container/hash/extendible_hash_table.h"
+
+namespace bustub {
+namespace {
+
+struct ReplayResult {
+  size_t hits_{0};
+  size_t misses_{0};
+  double ns_per_access_{0};
+  size_t num_buckets_{0};
+  int global_depth_{0};
+};
+
+auto LoadTrace(const std::string &path) -> std::vector<TraceRecord> {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("cannot open trace " + path);
+  }
+  TraceReader reader(in);
+  std::vector<TraceRecord> trace;
+  TraceRecord record;
+  while (reader.Next(&record)) {
+    trace.push_back(record);
+  }
+  return trace;
+}
+
+/** 命中时只记录访问；未命中时先用空闲帧，没有空闲帧再淘汰，并从页表中删除被淘汰的页面 */
+template <typename Hash>
+auto Replay(const std::vector<TraceRecord> &trace, ReplacerPolicy policy, size_t num_frames, size_t k,
+            size_t bucket_size) -> ReplayResult {
+  auto replacer = MakeReplacer(policy, num_frames, k);
+  ExtendibleHashTable<page_id_t, int, Hash> page_table(bucket_size);
+  std::vector<page_id_t> frame_page(num_frames, INVALID_PAGE_ID);
+  size_t used_frames = 0;
+  ReplayResult result;
+
+  auto start = std::chrono::steady_clock::now();
+  for (const auto &record : trace) {
+    frame_id_t frame_id;
+    if (page_table.Find(record.page_id_, frame_id)) {
+      result.hits_++;
+      replacer->RecordAccess(frame_id, record.access_type_, record.page_id_);
+      continue;
+    }
+    result.misses_++;
+    if (used_frames < num_frames) {
+      frame_id = static_cast<frame_id_t>(used_frames++);
+    } else {
+      if (!replacer->Evict(&frame_id)) {
+        throw std::runtime_error("replacer has no victim although no frame is pinned");
+      }
+      page_table.Remove(frame_page[frame_id]);
+    }
+    page_table.Insert(record.page_id_, frame_id);
+    frame_page[frame_id] = record.page_id_;
+    replacer->RecordAccess(frame_id, record.access_type_, record.page_id_);
+    replacer->SetEvictable(frame_id, true);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  result.ns_per_access_ = trace.empty() ? 0
+                                        : static_cast<double>(std::chrono::nanoseconds(elapsed).count()) /
+                                              static_cast<double>(trace.size());
+  result.num_buckets_ = page_table.GetNumBuckets();
+  result.global_depth_ = page_table.GetGlobalDepth();
+  return result;
+}
+
+void Usage(const char *prog) {
+  std::cerr << "usage: " << prog
+            << " <trace> [--frames N] [--k K] [--bucket-size B] [--policy all|lru_k|partitioned_lru_k|arc|2q|clock]"
+               " [--hash std|mix|both]\n";
+  std::exit(2);
+}
+
+}  // namespace
+}  // namespace bustub
+
+auto main(int argc, char **argv) -> int {
+  using bustub::ReplacerPolicy;
+  if (argc < 2) {
+    bustub::Usage(argv[0]);
+  }
+  std::string trace_path = argv[1];
+  size_t num_frames = 1024;
+  size_t k = 2;
+  size_t bucket_size = 16;
+  std::string policy_arg = "all";
+  std::string hash_arg = "both";
+  for (int i = 2; i < argc; i++) {
+    std::string flag = argv[i];
+    if (i + 1 == argc) {
+      bustub::Usage(argv[0]);
+    }
+    std::string value = argv[++i];
+    if (flag == "--frames") {
+      num_frames = std::stoul(value);
+    } else if (flag == "--k") {
+      k = std::stoul(value);
+    } else if (flag == "--bucket-size") {
+      bucket_size = std::stoul(value);
+    } else if (flag == "--policy") {
+      policy_arg = value;
+    } else if (flag == "--hash") {
+      hash_arg = value;
+    } else {
+      bustub::Usage(argv[0]);
+    }
+  }
+  if (num_frames == 0 || k == 0 || bucket_size == 0 ||
+      (hash_arg != "std" && hash_arg != "mix" && hash_arg != "both")) {
+    bustub::Usage(argv[0]);
+  }
+
+  std::vector<bustub::TraceRecord> trace;
+  try {
+    trace = bustub::LoadTrace(trace_path);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  std::printf("%zu accesses, %zu frames, k=%zu, bucket size %zu\n", trace.size(), num_frames, k, bucket_size);
+  std::printf("%-18s %-5s %10s %10s %9s %10s %8s %6s\n", "policy", "hash", "hits", "misses", "hit%", "ns/access",
+              "buckets", "depth");
+
+  bool matched = false;
+  for (const auto &entry : bustub::POLICIES) {
+    if (policy_arg != "all" && policy_arg != entry.name_) {
+      continue;
+    }
+    matched = true;
+    for (const char *hash : {"std", "mix"}) {
+      if (hash_arg != "both" && hash_arg != hash) {
+        continue;
+      }
+      auto result = std::string(hash) == "std"
+                        ? bustub::Replay<std::hash<bustub::page_id_t>>(trace, entry.policy_, num_frames, k, bucket_size)
+                        : bustub::Replay<bustub::IntegerMixHash<bustub::page_id_t>>(trace, entry.policy_, num_frames,
+                                                                                     k, bucket_size);
+      size_t total = result.hits_ + result.misses_;
+      std::printf("%-18s %-5s %10zu %10zu %8.2f%% %10.1f %8zu %6d\n", entry.name_, hash, result.hits_, result.misses_,
+                  total == 0 ? 0.0 : 100.0 * static_cast<double>(result.hits_) / static_cast<double>(total),
+                  result.ns_per_access_, result.num_buckets_, result.global_depth_);
+    }
+  }
+  if (!matched) {
+    bustub::Usage(argv[0]);
+  }
+  return 0;
+}
@@ -0,0 +1,107 @@
+#include "buffer/two_queue_replacer.h"
+
+#include <algorithm>
+
+namespace bustub
+{
+
+  TwoQueueReplacer::TwoQueueReplacer(size_t num_frames)
+      : replacer_size_(num_frames),
+        max_a1in_(std::max<size_t>(1, num_frames / 4)),
+        max_a1out_(std::max<size_t>(1, num_frames / 2)),
+        frames_(num_frames),
+        lists_(num_frames, 2)
+  {
+  }
+
+  /*Evict淘汰帧：A1in 超过 Kin 时按 FIFO 淘汰 A1in 中的可驱逐帧，并把它的页面记入 A1out；
+   否则淘汰 Am 中最久未访问的可驱逐帧。选中的链表没有可驱逐帧时改用另一个链表。
+  */
+  auto TwoQueueReplacer::Evict(frame_id_t *frame_id) -> bool
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (lists_.NumEvictable() == 0)
+    {
+      return false;
+    }
+    int list = lists_.Size(A1IN) > max_a1in_ ? A1IN : AM;
+    frame_id_t victim = lists_.FindVictim(list);
+    if (victim == FrameLists::NONE)
+    {
+      list = 1 - list;
+      victim = lists_.FindVictim(list);
+    }
+
+    lists_.Erase(victim);
+    FrameInfo &frame = frames_[victim];
+    if (list == A1IN && frame.page_id != INVALID_PAGE_ID)
+    {
+      a1out_.Push(frame.page_id);
+      if (a1out_.Size() > max_a1out_)
+      {
+        a1out_.PopOldest();
+      }
+    }
+    frame = FrameInfo{};
+    *frame_id = victim;
+    return true;
+  }
+
+  /*RecordAccess记录帧访问
+   Am 中的帧移到最前端；A1in 中的帧不动（短时间内的重复访问视为相关访问）。
+   新帧的页面在 A1out 中时直接进入 Am，否则进入 A1in。
+  */
+  void TwoQueueReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type, page_id_t page_id)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    int list = lists_.ListOf(frame_id);
+    if (list == AM)
+    {
+      lists_.MoveToFront(AM, frame_id);
+      return;
+    }
+    if (list == A1IN)
+    {
+      return;
+    }
+
+    frames_[frame_id].page_id = page_id;
+    if (access_type != AccessType::Scan && page_id != INVALID_PAGE_ID && a1out_.Erase(page_id))
+    {
+      lists_.PushFront(AM, frame_id);
+    }
+    else
+    {
+      lists_.PushFront(A1IN, frame_id);
+    }
+  }
+
+  void TwoQueueReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    BUSTUB_ASSERT(static_cast<size_t>(frame_id) < replacer_size_, "Invalid frame_id!");
+    lists_.SetEvictable(frame_id, set_evictable);
+  }
+
+  // Remove移除指定帧：页面已被删除，不记入 A1out
+  void TwoQueueReplacer::Remove(frame_id_t frame_id)
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (frame_id < 0 || static_cast<size_t>(frame_id) >= replacer_size_)
+    {
+      return;
+    }
+    if (lists_.Remove(frame_id))
+    {
+      frames_[frame_id] = FrameInfo{};
+    }
+  }
+
+  auto TwoQueueReplacer::Size() -> size_t
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return lists_.NumEvictable();
+  }
+
+} // namespace bustub
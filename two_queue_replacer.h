@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mutex> // NOLINT
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub
+{
+
+  /**
+   * TwoQueueReplacer implements the full 2Q policy (Johnson and Shasha, VLDB '94).
+   *
+   * A frame seen for the first time enters the FIFO A1in; further accesses while it is there are
+   * treated as correlated and ignored. Frames evicted from A1in leave their page in the ghost FIFO
+   * A1out. A page read back while remembered in A1out has proven reuse and enters the LRU list Am.
+   * Evict takes from A1in while it holds more than a quarter of the frames, from Am otherwise.
+   *
+   * Promotion needs the page id passed to RecordAccess. Scan accesses never promote a page.
+   */
+  class TwoQueueReplacer : public Replacer
+  {
+  public:
+    explicit TwoQueueReplacer(size_t num_frames);
+
+    DISALLOW_COPY_AND_MOVE(TwoQueueReplacer);
+
+    ~TwoQueueReplacer() override = default;
+
+    auto Evict(frame_id_t *frame_id) -> bool override;
+
+    void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown,
+                      page_id_t page_id = INVALID_PAGE_ID) override;
+
+    void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+    void Remove(frame_id_t frame_id) override;
+
+    auto Size() -> size_t override;
+
+  private:
+    static constexpr int A1IN = 0;
+    static constexpr int AM = 1;
+
+    struct FrameInfo
+    {
+      page_id_t page_id{INVALID_PAGE_ID};
+    };
+
+    size_t replacer_size_;
+    size_t max_a1in_;     // Kin：A1in 的目标大小，为总帧数的 1/4
+    size_t max_a1out_;    // Kout：A1out 最多记住的页面数，为总帧数的 1/2
+    std::mutex latch_;
+
+    std::vector<FrameInfo> frames_;
+    FrameLists lists_;
+    GhostList a1out_;
+  };
+
+} // namespace bustub